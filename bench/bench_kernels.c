@@ -0,0 +1,80 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../include/kernels.h"
+
+/*
+ * Per-row cost of one gradient pass, unrolled kernel vs generic kernel,
+ * for every input count that has an unrolled kernel.
+ *
+ * Usage: bench_kernels [rows] [passes]
+ */
+
+#define DEFAULT_ROWS   4096
+#define DEFAULT_PASSES 2000
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Time `passes` gradient passes over `rows`; returns nanoseconds per row. */
+static double time_gradient(const LRKernels *k, const double *theta, double *const *rows,
+                            size_t m, size_t n_inputs, unsigned passes, double *grad) {
+    double start = now_sec();
+    for (unsigned p = 0; p < passes; ++p) {
+        for (size_t j = 0; j <= n_inputs; ++j) grad[j] = 0.0;
+        k->gradient(theta, rows, NULL, m, n_inputs, grad);
+    }
+    double elapsed = now_sec() - start;
+    return elapsed * 1e9 / ((double)m * (double)passes);
+}
+
+int main(int argc, char *argv[]) {
+    size_t m = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_ROWS;
+    unsigned passes = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : DEFAULT_PASSES;
+    if (m == 0 || passes == 0) {
+        fprintf(stderr, "Usage: %s [rows] [passes]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const size_t max_cols = KERNELS_MAX_UNROLLED + 1;
+    double *storage = malloc(m * max_cols * sizeof(double));
+    double **rows = malloc(m * sizeof(double*));
+    double theta[KERNELS_MAX_UNROLLED + 1];
+    double grad[KERNELS_MAX_UNROLLED + 1];
+    if (!storage || !rows) {
+        fprintf(stderr, "bench_kernels: memory allocation failed\n");
+        free(storage);
+        free(rows);
+        return EXIT_FAILURE;
+    }
+
+    srand(42);
+    for (size_t i = 0; i < m * max_cols; ++i) storage[i] = (double)rand() / RAND_MAX;
+    for (size_t j = 0; j < max_cols; ++j) theta[j] = 0.1 * (double)j;
+
+    printf("rows=%zu passes=%u\n", m, passes);
+    printf("%8s %14s %14s %8s\n", "features", "generic ns/row", "unrolled ns/row", "speedup");
+
+    double checksum = 0.0;
+    for (size_t n = 1; n <= KERNELS_MAX_UNROLLED; ++n) {
+        /* Rows are packed at the width of this run so both kernels stream the same bytes. */
+        for (size_t i = 0; i < m; ++i) rows[i] = storage + i * (n + 1);
+
+        double generic = time_gradient(kernels_generic(), theta, rows, m, n, passes, grad);
+        checksum += grad[0];
+        double unrolled = time_gradient(kernels_select(n), theta, rows, m, n, passes, grad);
+        checksum += grad[0];
+
+        printf("%8zu %14.3f %15.3f %7.2fx\n", n, generic, unrolled, generic / unrolled);
+    }
+    printf("checksum: %g\n", checksum);
+
+    free(rows);
+    free(storage);
+    return EXIT_SUCCESS;
+}
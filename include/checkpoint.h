@@ -0,0 +1,59 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Training checkpoints.
+ *
+ * A checkpoint records the parameters, the number of completed iterations,
+ * the step schedule (learning rate and mini-batch size; mini-batch windows
+ * are deterministic, so there is no other optimizer state) and a fingerprint
+ * of the training data. Records carry a
+ * checksum and are written to a temporary file that is fsync'ed and renamed
+ * into place, so a reader never sees a partial write. The previous checkpoint
+ * is kept as "<path>.1" until the new one is in place.
+ *
+ * Writes happen on a background thread; checkpoint_submit() only copies the
+ * parameters, so training never waits for the disk.
+ */
+typedef struct Checkpointer Checkpointer;
+
+/*
+ * Start a checkpoint writer for `path`.
+ *   fingerprint: dataset fingerprint stored in each record (see csv_fingerprint())
+ *   n_params:    number of parameters (theta length)
+ * Returns NULL on failure (message printed).
+ */
+Checkpointer* checkpoint_open(const char *path, uint64_t fingerprint, size_t n_params);
+
+/*
+ * Queue a snapshot for writing. If the writer is still busy with an earlier
+ * snapshot, only the newest pending one is written. `batch_size` is the
+ * number of rows per step, 0 for full batch.
+ */
+void checkpoint_submit(Checkpointer *cp, uint64_t iteration, double alpha, uint64_t batch_size,
+                       const double *theta);
+
+/*
+ * Write any pending snapshot, stop the writer and free `cp`.
+ * Returns 0 if every write succeeded, -1 otherwise.
+ */
+int checkpoint_close(Checkpointer *cp);
+
+/*
+ * Load the newest valid checkpoint from `path` or "<path>.1".
+ * Records with a bad checksum, another parameter count or another dataset
+ * fingerprint are skipped.
+ *
+ * On success fills theta (n_params values), *iteration, *alpha and
+ * *batch_size. The caller decides whether the stored schedule matches the
+ * run being resumed.
+ * Returns 1 if a checkpoint was loaded, 0 if none was usable.
+ */
+int checkpoint_load_latest(const char *path, uint64_t fingerprint, size_t n_params,
+                           double *theta, uint64_t *iteration, double *alpha,
+                           uint64_t *batch_size);
+
+#endif /* CHECKPOINT_H */
@@ -0,0 +1,148 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stddef.h>
+#include "csv_reader.h"
+#include "gradient_descent.h"
+
+/*
+ * Runtime configuration.
+ *
+ * Every setting has a key that is accepted, with the same value syntax, from
+ * each source. Later sources override earlier ones:
+ *   1. built-in defaults
+ *   2. the tuned profile (`profile` key, CONFIG_DEFAULT_PROFILE in the
+ *      working directory when unset) if it exists, unless autotune is requested
+ *   3. the config file (--config=PATH or LR_CONFIG)
+ *   4. environment variables: LR_ + key in upper case with '-' as '_'
+ *      (e.g. LR_LEARNING_RATE=0.05)
+ *   5. command line: --key=value, or --key alone for on/off settings
+ *
+ * Config files and profiles hold one "key = value" per line; '#' starts a
+ * comment. Sizes accept K, M and G suffixes (powers of 1024).
+ *
+ * Keys:
+ *   data, target, features (comma separated)   - what to load (see CSVSchema)
+ *   learning-rate, iterations                  - optimization
+ *   solver (batch | minibatch), batch-size     - rows per step for minibatch
+ *   threads, pin, placement                    - see GDOptions
+ *   precision (double)                         - floating-point type
+ *   kernel (auto | rows | blocked), block-size - gradient kernel and tile size
+ *   tuned-inputs                               - input count the kernel and
+ *                                                block-size were tuned for;
+ *                                                cleared when either is set
+ *   memory-budget                              - max bytes for loaded rows and
+ *                                                training buffers, 0 = no limit
+ *   dedup                                      - compact duplicate rows
+ *   checkpoint, checkpoint-every               - checkpoint path and interval
+ *   profile, autotune                          - tuned profile path; tune and save it
+ */
+
+#define CONFIG_DEFAULT_LEARNING_RATE 0.01
+#define CONFIG_DEFAULT_ITERATIONS 1000
+#define CONFIG_DEFAULT_BATCH_SIZE 256
+#define CONFIG_DEFAULT_PROFILE "lr_profile.conf"
+
+typedef enum {
+    CONFIG_SOLVER_BATCH = 0,
+    CONFIG_SOLVER_MINIBATCH
+} ConfigSolver;
+
+/* Training runs in double precision throughout; the key exists so profiles
+ * and config files state it explicitly and other values are rejected. */
+typedef enum {
+    CONFIG_PRECISION_DOUBLE = 0
+} ConfigPrecision;
+
+typedef struct {
+    char *data_path;
+    char *target;
+    char **features;
+    size_t n_features;
+
+    double learning_rate;
+    unsigned int iterations;
+    ConfigSolver solver;
+    size_t batch_size;
+
+    unsigned int threads;
+    GDPinPolicy pin;
+    GDPlacement placement;
+    ConfigPrecision precision;
+    GDKernel kernel;
+    size_t block_bytes;
+    size_t tuned_inputs;    /* inputs kernel and block_bytes were tuned for, 0 = any */
+    size_t memory_budget;
+
+    int dedup;
+    char *checkpoint_path;
+    unsigned int checkpoint_every;
+    char *profile_path;
+    int autotune;
+} LRConfig;
+
+/* Fill `cfg` with the built-in defaults (profile_path stays NULL). */
+void config_init(LRConfig *cfg);
+
+/*
+ * Set one key from a string value. `origin` names the source in error
+ * messages (e.g. "lr.conf:3" or "LR_THREADS").
+ * Returns 0 on success, -1 on an unknown key or invalid value (message printed).
+ */
+int config_set(LRConfig *cfg, const char *key, const char *value, const char *origin);
+
+/* Apply a config file or profile. Returns 0 on success, -1 on error. */
+int config_load_file(LRConfig *cfg, const char *path);
+
+/*
+ * Build the configuration from all sources in precedence order. Positional
+ * command-line arguments are <data> [target [feature...]].
+ *
+ * Returns 0 on success, 1 if --help was given, -1 on error (message printed).
+ * The caller must release `cfg` with config_free() in every case.
+ */
+int config_load(LRConfig *cfg, int argc, char *argv[]);
+
+/* Translate `cfg` into training options (checkpoint fields are left unset). */
+void config_gd_options(const LRConfig *cfg, GDOptions *opts);
+
+/*
+ * Drop a tuned kernel and block size that do not fit `data`: when
+ * cfg->tuned_inputs is set and differs from the number of inputs in `data`,
+ * kernel falls back to auto and block size to its default (a note is printed).
+ * Returns 1 if the tuned values were dropped, 0 if they are kept.
+ */
+int config_match_profile(LRConfig *cfg, const CSVData *data);
+
+/*
+ * Check the loaded `data` plus the training buffers (gd_working_set()) against
+ * cfg->memory_budget. When only first-touch placement's row copies exceed the
+ * budget, opts->placement falls back to shared (a note is printed).
+ * The loader enforces the same budget on the raw rows (CSVSchema.max_bytes);
+ * this check covers training only, not temporary buffers such as dedup's.
+ * Call it with the final options, after config_match_profile() and
+ * config_autotune() have settled kernel, threads and block size.
+ * Returns 0 if training fits, -1 otherwise (message printed).
+ */
+int config_check_memory(const LRConfig *cfg, const CSVData *data, GDOptions *opts);
+
+/*
+ * Micro-benchmark kernel variants, thread counts and block sizes on (a
+ * prefix of) `data` on this host, store the fastest combination in `cfg`
+ * and save it as a profile to cfg->profile_path (CONFIG_DEFAULT_PROFILE when
+ * unset), where config_load() finds it on later runs.
+ * Returns 0 on success, -1 on failure.
+ */
+int config_autotune(LRConfig *cfg, const CSVData *data);
+
+/* Write the tuned settings of `cfg` (kernel, threads, block-size and
+ * tuned-inputs when set) as a profile. */
+int config_save_profile(const LRConfig *cfg, const char *path);
+
+/* Print command-line usage to stderr. */
+void config_usage(const char *prog);
+
+/* Free strings owned by `cfg` (the struct itself is not freed). */
+void config_free(LRConfig *cfg);
+
+#endif /* CONFIG_H */
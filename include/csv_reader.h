@@ -2,24 +2,61 @@
 #define CSV_READER_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 /*
  * CSVData
  *   - data: pointer to array of rows; each row is a double array of length `cols`.
+ *   - values: contiguous row-major storage the rows point into (row i starts at
+ *             values + i * cols), or NULL if each row was allocated separately.
+ *             csv_read() always fills it; csv_free() releases whichever layout is used.
  *   - rows: number of data rows
  *   - cols: number of columns per row
+ *   - col_names: header name of each column (length `cols`), or NULL if the
+ *                file had no header
+ *   - weights: per-row sample weights (length `rows`), or NULL if every row
+ *              counts once. A row with weight k stands for k identical rows.
  *
  * Format expectation for this project:
- *   - Each row should contain numeric fields only.
- *   - The last column is expected to be the target (y); earlier columns are features (x1..xn).
- *   - If the file has a header (non-numeric first non-empty line), it will be auto-skipped.
+ *   - Selected fields must be numeric; unselected fields are never parsed.
+ *   - The last column is the target (y); earlier columns are features (x1..xn).
+ *     csv_read_schema() reorders the source columns into this layout.
+ *   - If the file has a header, it is not treated as data; its names are kept
+ *     in `col_names`. The first non-empty line is a header when a column the
+ *     schema selects holds text there; with a projection, unselected columns
+ *     may hold text in a headerless file. A first line fitting neither reading
+ *     is rejected.
  */
 typedef struct {
     double **data;
+    double *values;
     size_t rows;
     size_t cols;
+    char **col_names;
+    double *weights;
 } CSVData;
 
+/*
+ * CSVSchema
+ *   Load-time column selection. Each selector is either a header name or a
+ *   0-based column index written in decimal ("3"); a matching header name
+ *   takes precedence over the index reading.
+ *
+ *   - features:   selectors of the feature columns, in output order.
+ *                 NULL (or n_features == 0) selects every non-target column.
+ *   - n_features: number of entries in `features`
+ *   - target:     selector of the target column; NULL selects the last column.
+ *   - max_bytes:  limit on the loaded rows (values plus row pointers); loading
+ *                 fails once the rows read so far would exceed it, before the
+ *                 storage grows past it. 0 means no limit.
+ */
+typedef struct {
+    const char *const *features;
+    size_t n_features;
+    const char *target;
+    size_t max_bytes;
+} CSVSchema;
+
 /* Read CSV file at `filename` and return a CSVData* on success, NULL on failure.
  * The caller must free the returned object using csv_free().
  *
@@ -28,6 +65,29 @@ typedef struct {
  */
 CSVData* csv_read(const char *filename);
 
+/* Like csv_read(), but keep only the columns chosen by `schema` (NULL behaves
+ * like csv_read()). The result holds the selected features in schema order
+ * followed by the target, so it can be passed to gradient_descent() directly.
+ *
+ * Fields of unselected columns are skipped by a delimiter scan and are not
+ * validated. Unknown or duplicated selectors cause failure.
+ */
+CSVData* csv_read_schema(const char *filename, const CSVSchema *schema);
+
+/* Collapse exactly repeated rows (all columns equal) into one weighted row.
+ * The first occurrence keeps its position; its weight becomes the sum of the
+ * weights of all its copies (1 each if `csv->weights` was NULL). Rows holding
+ * NaN are never merged.
+ *
+ * Returns the number of rows removed, or -1 on memory allocation failure (csv
+ * is left unchanged).
+ */
+long csv_compact_duplicates(CSVData *csv);
+
+/* 64-bit fingerprint of the shape, values and weights of `csv`. Used to tie
+ * checkpoints to the data they were trained on. */
+uint64_t csv_fingerprint(const CSVData *csv);
+
 /* Free CSVData returned by csv_read */
 void csv_free(CSVData *csv);
 
@@ -3,6 +3,125 @@
 
 #include "linear_regression.h"
 #include "csv_reader.h"
+#include "checkpoint.h"
+
+/*
+ * Thread placement for training workers.
+ *   GD_PIN_NONE  - workers are not pinned; the OS schedules them freely.
+ *   GD_PIN_CORE  - each worker is pinned to one CPU of its NUMA node.
+ *   GD_PIN_NODE  - each worker may run on any CPU of its NUMA node.
+ */
+typedef enum {
+    GD_PIN_NONE = 0,
+    GD_PIN_CORE,
+    GD_PIN_NODE
+} GDPinPolicy;
+
+/*
+ * Where training rows live while workers read them.
+ *   GD_PLACE_SHARED      - workers read the loaded CSVData in place.
+ *   GD_PLACE_FIRST_TOUCH - each worker copies its row block into memory it
+ *                          touches first, so the pages land on its own node.
+ *                          The copies are made by every gradient_descent_ex()
+ *                          call and live next to the loaded rows, so peak data
+ *                          memory is twice the dataset; an autotune run pays
+ *                          the copy again for each candidate it times.
+ */
+typedef enum {
+    GD_PLACE_SHARED = 0,
+    GD_PLACE_FIRST_TOUCH
+} GDPlacement;
+
+/*
+ * Gradient kernel used per iteration.
+ *   GD_KERNEL_AUTO    - rows for up to KERNELS_MAX_UNROLLED features, blocked above
+ *   GD_KERNEL_ROWS    - fused row-by-row kernel (unrolled when one exists)
+ *   GD_KERNEL_BLOCKED - blocked GEMV formulation through linalg.h
+ */
+typedef enum {
+    GD_KERNEL_AUTO = 0,
+    GD_KERNEL_ROWS,
+    GD_KERNEL_BLOCKED
+} GDKernel;
+
+/*
+ * GDOptions
+ *   - threads:   number of training workers; 0 uses one per available CPU.
+ *                Never more workers than rows are started.
+ *   - pin:       thread pinning policy
+ *   - placement: data placement policy
+ *   - kernel:    gradient kernel selection
+ *   - block_bytes: target size of one row block in the blocked kernel
+ *                (0 = GD_DEFAULT_BLOCK_BYTES)
+ *   - batch_size: rows per step; 0 (or >= rows) is full-batch gradient
+ *                descent. Mini-batches are consecutive row windows that
+ *                advance by batch_size rows each iteration, wrapping around,
+ *                so the sequence depends only on the iteration number.
+ *   - checkpoint:          writer for periodic checkpoints, NULL to disable
+ *   - checkpoint_interval: iterations between checkpoints (0 = only at the end)
+ *   - start_iteration:     iterations completed before this call, when
+ *                          resuming; checkpoints count from here
+ *
+ * Rows are split into contiguous blocks, one per NUMA node in proportion to
+ * the workers assigned to it, and each worker trains on rows of its own node.
+ */
+typedef struct {
+    unsigned int threads;
+    GDPinPolicy pin;
+    GDPlacement placement;
+    GDKernel kernel;
+    size_t block_bytes;
+    size_t batch_size;
+    Checkpointer *checkpoint;
+    unsigned int checkpoint_interval;
+    unsigned int start_iteration;
+} GDOptions;
+
+#define GD_STATS_MAX_NODES 16
+
+/* Default target size of one row block of X in the blocked kernel; sized so
+ * the block stays in L2 between the X*theta and X^T*e products. */
+#define GD_DEFAULT_BLOCK_BYTES (256 * 1024)
+
+/*
+ * GDStats: how a training run was executed.
+ *   - threads:        workers used
+ *   - nodes_detected: NUMA nodes usable by the process
+ *   - nodes:          per-node system id, worker count and row count for the
+ *                     nodes that received workers (first GD_STATS_MAX_NODES)
+ *   - n_nodes:        number of valid entries in `nodes`
+ *   - pin_failures:   workers whose pinning request was refused
+ *   - kernel:         "unrolled", "generic" or "blocked-gemv"
+ *   - backend:        linear algebra backend of the blocked path
+ *   - backend_threads: threads the backend used per call (forced to 1 when
+ *                     several workers run, so they do not oversubscribe cores)
+ *   - block_rows:     rows per block in the blocked path (0 if unused)
+ *   - batch_size:     rows per step (equals the row count for full batch)
+ *   - checkpoints:    snapshots handed to the checkpoint writer
+ */
+typedef struct {
+    unsigned int threads;
+    size_t nodes_detected;
+    struct {
+        int id;
+        unsigned int threads;
+        size_t rows;
+    } nodes[GD_STATS_MAX_NODES];
+    size_t n_nodes;
+    unsigned int pin_failures;
+    GDPinPolicy pin;
+    GDPlacement placement;
+    const char *kernel;
+    const char *backend;
+    int backend_threads;
+    size_t block_rows;
+    size_t batch_size;
+    unsigned int checkpoints;
+} GDStats;
+
+/* Fill `opts` with the defaults used by gradient_descent(): one worker,
+ * no pinning, shared placement, automatic kernel, full batch, no checkpoints. */
+void gd_default_options(GDOptions *opts);
 
 /*
  * Train a LinearRegression model using batch gradient descent.
@@ -20,6 +139,12 @@
  * Note:
  *   - Adds a bias term automatically (x0 = 1).
  *   - Updates lr->theta in-place.
+ *   - Honors data->weights: the gradient is the weighted mean over rows,
+ *     identical to training on the expanded (duplicated) rows.
+ *   - Up to KERNELS_MAX_UNROLLED features, each iteration is a single fused
+ *     pass with an unrolled kernel. Above that it is computed as two blocked
+ *     matrix-vector products (X*theta - y, then X^T*e) through linalg.h, which
+ *     uses CBLAS when available. GDOptions.kernel can force either path.
  */
 int gradient_descent(
     LinearRegression *lr,
@@ -28,4 +153,41 @@ int gradient_descent(
     unsigned int iterations
 );
 
+/*
+ * gradient_descent() with explicit execution options.
+ *
+ * Parameters:
+ *   opts  - execution options; NULL uses gd_default_options()
+ *   stats - if not NULL, receives how the run was executed
+ *
+ * Returns 0 on success, -1 on invalid parameters or resource failure.
+ *
+ * Note:
+ *   With more than one worker the partial gradients are summed in worker
+ *   order, so results are deterministic for a given thread count but may
+ *   differ from a single-threaded run in the last bits.
+ *   With opts->checkpoint set, worker 0 hands a snapshot to the writer every
+ *   checkpoint_interval iterations and once more when training ends; the
+ *   write itself happens on the writer's thread.
+ */
+int gradient_descent_ex(
+    LinearRegression *lr,
+    const CSVData *data,
+    double alpha,
+    unsigned int iterations,
+    const GDOptions *opts,
+    GDStats *stats
+);
+
+/*
+ * Bytes gradient_descent_ex() allocates for `data` under `opts` on top of the
+ * data itself: per-worker gradient and error buffers, the per-node row copies
+ * of first-touch placement, and the weight prefix sums of weighted
+ * mini-batches. NULL opts means gd_default_options().
+ */
+size_t gd_working_set(const CSVData *data, const GDOptions *opts);
+
+/* Print `stats` (topology, threads, kernel) to stdout. */
+void gd_print_stats(const GDStats *stats);
+
 #endif /* GRADIENT_DESCENT_H */
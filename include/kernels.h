@@ -0,0 +1,50 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stddef.h>
+
+/*
+ * Inner loops of training and prediction.
+ *
+ * For small input counts (1..KERNELS_MAX_UNROLLED features, bias excluded)
+ * fully unrolled kernels are generated at compile time; they keep theta and the
+ * gradient accumulators in locals so the compiler can hold them in registers.
+ * Any other input count uses the generic loops.
+ *
+ * All kernels accumulate in the same order as the generic loops, starting
+ * from the values already in `grad`, so results are bit-identical whichever
+ * kernel is selected, also when a kernel adds to a partially filled `grad`.
+ */
+#define KERNELS_MAX_UNROLLED 16
+
+/*
+ * Predict theta[0] + sum_j theta[j + 1] * x[j] for one row.
+ *   theta:    n_inputs + 1 parameters (bias first)
+ *   x:        n_inputs feature values
+ */
+typedef double (*kernel_predict_fn)(const double *theta, const double *x, size_t n_inputs);
+
+/*
+ * Add the unscaled squared-error gradient over `m` rows to `grad`.
+ *   theta:    n_inputs + 1 parameters (bias first)
+ *   rows:     m rows of n_inputs features followed by the target
+ *   w:        m sample weights scaling each row's error, or NULL for all 1
+ *   grad:     n_inputs + 1 accumulators (not cleared by the kernel)
+ */
+typedef void (*kernel_gradient_fn)(const double *theta, double *const *rows, const double *w,
+                                   size_t m, size_t n_inputs, double *grad);
+
+typedef struct {
+    kernel_predict_fn predict;
+    kernel_gradient_fn gradient;
+    size_t unrolled;    /* input count the kernels are specialized for, 0 if generic */
+} LRKernels;
+
+/* Return the kernels for `n_inputs` features: an unrolled set when one exists,
+ * otherwise the generic set. Never returns NULL. */
+const LRKernels* kernels_select(size_t n_inputs);
+
+/* Return the generic kernels (valid for any input count). */
+const LRKernels* kernels_generic(void);
+
+#endif /* KERNELS_H */
@@ -0,0 +1,32 @@
+#ifndef LINALG_H
+#define LINALG_H
+
+#include <stddef.h>
+
+/*
+ * Dense matrix-vector products used by the blocked training path.
+ *
+ * Matrices are row-major: element (i, j) of A is a[i * lda + j], lda >= n.
+ * When the build detects a system CBLAS (LR_HAVE_CBLAS), these forward to
+ * cblas_dgemv(); otherwise portable loops are used.
+ */
+
+/* y = alpha * A x + beta * y, with A of size m x n, x of length n, y of length m. */
+void linalg_gemv(size_t m, size_t n, double alpha, const double *a, size_t lda,
+                 const double *x, double beta, double *y);
+
+/* y = alpha * A^T x + beta * y, with A of size m x n, x of length m, y of length n. */
+void linalg_gemv_t(size_t m, size_t n, double alpha, const double *a, size_t lda,
+                   const double *x, double beta, double *y);
+
+/* Threads the backend may use inside one call (always 1 for the portable loops). */
+int linalg_get_threads(void);
+
+/* Limit the backend's internal threading to `n` threads (no-op for the portable
+ * loops). Process-wide: call it while no other thread is inside linalg. */
+void linalg_set_threads(int n);
+
+/* Name of the active backend ("cblas" or "portable"). */
+const char* linalg_backend_name(void);
+
+#endif /* LINALG_H */
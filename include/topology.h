@@ -0,0 +1,55 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <stddef.h>
+
+/*
+ * TopologyNode
+ *   - id:     system NUMA node id
+ *   - cpus:   CPUs of the node this process may run on
+ *   - n_cpus: number of entries in `cpus` (always > 0)
+ */
+typedef struct {
+    int id;
+    int *cpus;
+    size_t n_cpus;
+} TopologyNode;
+
+/*
+ * Topology
+ *   NUMA nodes usable by this process, in ascending id order. Nodes whose CPUs
+ *   are all outside the process affinity mask are left out.
+ */
+typedef struct {
+    TopologyNode *nodes;
+    size_t n_nodes;
+} Topology;
+
+/* Detect the NUMA layout from /sys/devices/system/node. When that is not
+ * available (non-Linux, containers without sysfs), a single node holding all
+ * online CPUs is reported.
+ *
+ * Returns 0 on success, -1 on memory allocation failure.
+ * The caller must release the result with topology_free().
+ */
+int topology_detect(Topology *topo);
+
+/* Parse a kernel list format string ("0-3,8,10-11") into a malloc'd array,
+ * as found in the sysfs cpulist and online files.
+ * Returns 0 on success (an empty list yields *out = NULL, *out_n = 0),
+ * -1 on malformed input or memory allocation failure.
+ */
+int topology_parse_id_list(const char *s, int **out, size_t *out_n);
+
+/* Total number of CPUs over all nodes. */
+size_t topology_cpu_count(const Topology *topo);
+
+/* Pin the calling thread to `n_cpus` CPUs from `cpus`.
+ * Returns 0 on success, -1 if pinning failed or is unsupported on this platform.
+ */
+int topology_pin_thread(const int *cpus, size_t n_cpus);
+
+/* Free memory held by `topo` (the struct itself is not freed). */
+void topology_free(Topology *topo);
+
+#endif /* TOPOLOGY_H */
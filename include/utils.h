@@ -2,6 +2,10 @@
 #define UTILS_H
 
 #include <stddef.h>
+#include <stdint.h>
+
+/* Initial value for utils_hash_bytes(). */
+#define UTILS_HASH_INIT 14695981039346656037ULL
 
 /*
  * Print a vector of doubles.
@@ -19,9 +23,23 @@ void utils_print_vector(const char *label, const double *v, size_t n);
  */
 double utils_mse(const double *predictions, const double *targets, size_t m);
 
+/*
+ * Weighted Mean Squared Error: sum(w_i * (p_i - t_i)^2) / sum(w_i).
+ * weights: array of size m, or NULL for all 1 (same as utils_mse)
+ * Returns 0.0 if the weights sum to zero.
+ */
+double utils_weighted_mse(const double *predictions, const double *targets,
+                          const double *weights, size_t m);
+
 /*
  * Fill an array with zeros.
  */
 void utils_zero_vector(double *v, size_t n);
 
+/*
+ * 64-bit FNV-1a hash of `n` bytes at `p`, continuing from `h`
+ * (start with UTILS_HASH_INIT). Not cryptographic.
+ */
+uint64_t utils_hash_bytes(const void *p, size_t n, uint64_t h);
+
 #endif /* UTILS_H */
@@ -0,0 +1,307 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/checkpoint.h"
+#include "../include/utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/*
+ * Record layout (native byte order):
+ *   magic[8] "LRCKPT02"
+ *   uint64   iteration
+ *   uint64   n_params
+ *   uint64   fingerprint
+ *   double   alpha
+ *   uint64   batch_size
+ *   double   theta[n_params]
+ *   uint64   checksum (utils_hash_bytes over everything before it)
+ */
+#define CKPT_MAGIC "LRCKPT02"
+#define CKPT_MAGIC_LEN 8
+#define CKPT_HEADER_SIZE (CKPT_MAGIC_LEN + 4 * sizeof(uint64_t) + sizeof(double))
+
+struct Checkpointer {
+    char *path;
+    char *tmp_path;
+    char *prev_path;
+    uint64_t fingerprint;
+    size_t n_params;
+    size_t record_size;
+    unsigned char *pending;     /* newest submitted record, guarded by lock */
+    unsigned char *writing;     /* record owned by the writer thread */
+    int has_pending;
+    int stop;
+    int failed;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t thread;
+};
+
+/* ---------- Helpers (static) ---------- */
+
+static size_t record_size_for(size_t n_params) {
+    return CKPT_HEADER_SIZE + n_params * sizeof(double) + sizeof(uint64_t);
+}
+
+static void encode_record(unsigned char *buf, size_t n_params, uint64_t fingerprint,
+                          uint64_t iteration, double alpha, uint64_t batch_size,
+                          const double *theta) {
+    uint64_t n = n_params;
+    unsigned char *p = buf;
+    memcpy(p, CKPT_MAGIC, CKPT_MAGIC_LEN);  p += CKPT_MAGIC_LEN;
+    memcpy(p, &iteration, sizeof(uint64_t)); p += sizeof(uint64_t);
+    memcpy(p, &n, sizeof(uint64_t));         p += sizeof(uint64_t);
+    memcpy(p, &fingerprint, sizeof(uint64_t)); p += sizeof(uint64_t);
+    memcpy(p, &alpha, sizeof(double));       p += sizeof(double);
+    memcpy(p, &batch_size, sizeof(uint64_t)); p += sizeof(uint64_t);
+    memcpy(p, theta, n_params * sizeof(double));
+}
+
+static void seal_record(unsigned char *buf, size_t size) {
+    uint64_t sum = utils_hash_bytes(buf, size - sizeof(uint64_t), UTILS_HASH_INIT);
+    memcpy(buf + size - sizeof(uint64_t), &sum, sizeof(uint64_t));
+}
+
+static char *concat(const char *a, const char *b) {
+    size_t la = strlen(a), lb = strlen(b);
+    char *s = malloc(la + lb + 1);
+    if (!s) return NULL;
+    memcpy(s, a, la);
+    memcpy(s + la, b, lb + 1);
+    return s;
+}
+
+/* fsync the directory holding `path` so the renames themselves are durable. */
+static void sync_parent_dir(const char *path) {
+    const char *slash = strrchr(path, '/');
+    char *dir = slash ? malloc((size_t)(slash - path) + 2) : NULL;
+    if (slash && !dir) return;
+    if (dir) {
+        size_t len = (size_t)(slash - path);
+        if (len == 0) len = 1;      /* file in the root directory */
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    }
+    int fd = open(dir ? dir : ".", O_RDONLY);
+    free(dir);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+/* Write one sealed record: temp file, fsync, keep the old checkpoint as
+ * "<path>.1", then rename the new one into place. */
+static int write_record(const Checkpointer *cp, const unsigned char *buf) {
+    FILE *f = fopen(cp->tmp_path, "wb");
+    if (!f) {
+        perror("checkpoint: fopen");
+        return -1;
+    }
+    int ok = fwrite(buf, 1, cp->record_size, f) == cp->record_size;
+    ok = ok && fflush(f) == 0;
+    ok = ok && fsync(fileno(f)) == 0;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        fprintf(stderr, "checkpoint: failed writing '%s'\n", cp->tmp_path);
+        remove(cp->tmp_path);
+        return -1;
+    }
+
+    if (rename(cp->path, cp->prev_path) != 0 && errno != ENOENT) {
+        perror("checkpoint: rename");
+    }
+    if (rename(cp->tmp_path, cp->path) != 0) {
+        perror("checkpoint: rename");
+        return -1;
+    }
+    sync_parent_dir(cp->path);
+    return 0;
+}
+
+static void *writer_main(void *arg) {
+    Checkpointer *cp = arg;
+
+    pthread_mutex_lock(&cp->lock);
+    while (1) {
+        while (!cp->has_pending && !cp->stop) pthread_cond_wait(&cp->cond, &cp->lock);
+        if (!cp->has_pending) break;   /* stop requested, nothing left */
+
+        unsigned char *tmp = cp->writing;
+        cp->writing = cp->pending;
+        cp->pending = tmp;
+        cp->has_pending = 0;
+        pthread_mutex_unlock(&cp->lock);
+
+        seal_record(cp->writing, cp->record_size);
+        int r = write_record(cp, cp->writing);
+
+        pthread_mutex_lock(&cp->lock);
+        if (r != 0) cp->failed = 1;
+    }
+    pthread_mutex_unlock(&cp->lock);
+    return NULL;
+}
+
+/* Read and validate one checkpoint file. Returns 1 if usable. */
+static int read_record(const char *path, uint64_t fingerprint, size_t n_params,
+                       double *theta, uint64_t *iteration, double *alpha,
+                       uint64_t *batch_size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+
+    size_t size = record_size_for(n_params);
+    unsigned char *buf = malloc(size + 1);
+    if (!buf) {
+        fclose(f);
+        return 0;
+    }
+    /* one byte more than expected detects trailing data */
+    size_t got = fread(buf, 1, size + 1, f);
+    fclose(f);
+
+    uint64_t stored_sum, n, fp;
+    int ok = got == size && memcmp(buf, CKPT_MAGIC, CKPT_MAGIC_LEN) == 0;
+    if (ok) {
+        memcpy(&stored_sum, buf + size - sizeof(uint64_t), sizeof(uint64_t));
+        ok = stored_sum == utils_hash_bytes(buf, size - sizeof(uint64_t), UTILS_HASH_INIT);
+    }
+    if (!ok) {
+        fprintf(stderr, "checkpoint: '%s' is damaged or has another parameter count, ignoring\n", path);
+        free(buf);
+        return 0;
+    }
+
+    const unsigned char *p = buf + CKPT_MAGIC_LEN;
+    memcpy(iteration, p, sizeof(uint64_t));  p += sizeof(uint64_t);
+    memcpy(&n, p, sizeof(uint64_t));         p += sizeof(uint64_t);
+    memcpy(&fp, p, sizeof(uint64_t));        p += sizeof(uint64_t);
+    if (n != n_params || fp != fingerprint) {
+        fprintf(stderr, "checkpoint: '%s' was written for other data, ignoring\n", path);
+        free(buf);
+        return 0;
+    }
+    memcpy(alpha, p, sizeof(double));        p += sizeof(double);
+    memcpy(batch_size, p, sizeof(uint64_t)); p += sizeof(uint64_t);
+    memcpy(theta, p, n_params * sizeof(double));
+
+    free(buf);
+    return 1;
+}
+
+static void checkpointer_free(Checkpointer *cp) {
+    free(cp->path);
+    free(cp->tmp_path);
+    free(cp->prev_path);
+    free(cp->pending);
+    free(cp->writing);
+    free(cp);
+}
+
+/* ---------- Public API ---------- */
+
+Checkpointer* checkpoint_open(const char *path, uint64_t fingerprint, size_t n_params) {
+    if (!path || n_params == 0) {
+        fprintf(stderr, "checkpoint_open: invalid parameters\n");
+        return NULL;
+    }
+
+    Checkpointer *cp = calloc(1, sizeof(Checkpointer));
+    if (!cp) {
+        fprintf(stderr, "checkpoint_open: memory allocation failed\n");
+        return NULL;
+    }
+    cp->fingerprint = fingerprint;
+    cp->n_params = n_params;
+    cp->record_size = record_size_for(n_params);
+    cp->path = concat(path, "");
+    cp->tmp_path = concat(path, ".tmp");
+    cp->prev_path = concat(path, ".1");
+    cp->pending = malloc(cp->record_size);
+    cp->writing = malloc(cp->record_size);
+    if (!cp->path || !cp->tmp_path || !cp->prev_path || !cp->pending || !cp->writing) {
+        fprintf(stderr, "checkpoint_open: memory allocation failed\n");
+        checkpointer_free(cp);
+        return NULL;
+    }
+
+    pthread_mutex_init(&cp->lock, NULL);
+    pthread_cond_init(&cp->cond, NULL);
+    if (pthread_create(&cp->thread, NULL, writer_main, cp) != 0) {
+        fprintf(stderr, "checkpoint_open: failed to start writer thread\n");
+        pthread_cond_destroy(&cp->cond);
+        pthread_mutex_destroy(&cp->lock);
+        checkpointer_free(cp);
+        return NULL;
+    }
+    return cp;
+}
+
+void checkpoint_submit(Checkpointer *cp, uint64_t iteration, double alpha, uint64_t batch_size,
+                       const double *theta) {
+    if (!cp || !theta) return;
+    pthread_mutex_lock(&cp->lock);
+    encode_record(cp->pending, cp->n_params, cp->fingerprint, iteration, alpha, batch_size, theta);
+    cp->has_pending = 1;
+    pthread_cond_signal(&cp->cond);
+    pthread_mutex_unlock(&cp->lock);
+}
+
+int checkpoint_close(Checkpointer *cp) {
+    if (!cp) return 0;
+
+    pthread_mutex_lock(&cp->lock);
+    cp->stop = 1;
+    pthread_cond_signal(&cp->cond);
+    pthread_mutex_unlock(&cp->lock);
+    pthread_join(cp->thread, NULL);
+
+    int result = cp->failed ? -1 : 0;
+    pthread_cond_destroy(&cp->cond);
+    pthread_mutex_destroy(&cp->lock);
+    checkpointer_free(cp);
+    return result;
+}
+
+int checkpoint_load_latest(const char *path, uint64_t fingerprint, size_t n_params,
+                           double *theta, uint64_t *iteration, double *alpha,
+                           uint64_t *batch_size) {
+    if (!path || !theta || !iteration || !alpha || !batch_size || n_params == 0) return 0;
+
+    char *prev = concat(path, ".1");
+    double *cand = malloc(n_params * sizeof(double));
+    if (!prev || !cand) {
+        free(prev);
+        free(cand);
+        return 0;
+    }
+
+    uint64_t it_cur = 0, it_prev = 0, batch_cur = 0, batch_prev = 0;
+    double alpha_cur = 0.0, alpha_prev = 0.0;
+    int have_cur = read_record(path, fingerprint, n_params, theta, &it_cur, &alpha_cur, &batch_cur);
+    int have_prev = read_record(prev, fingerprint, n_params, cand, &it_prev, &alpha_prev,
+                                &batch_prev);
+
+    int found = 0;
+    if (have_prev && (!have_cur || it_prev > it_cur)) {
+        memcpy(theta, cand, n_params * sizeof(double));
+        *iteration = it_prev;
+        *alpha = alpha_prev;
+        *batch_size = batch_prev;
+        found = 1;
+    } else if (have_cur) {
+        *iteration = it_cur;
+        *alpha = alpha_cur;
+        *batch_size = batch_cur;
+        found = 1;
+    }
+
+    free(prev);
+    free(cand);
+    return found;
+}
@@ -0,0 +1,682 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/config.h"
+#include "../include/linear_regression.h"
+#include "../include/linalg.h"
+#include "../include/topology.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+
+/* Autotune works on at most this many rows and aims for roughly this many
+ * multiply-adds per timed run. */
+#define AUTOTUNE_MAX_ROWS 65536
+#define AUTOTUNE_WORK 4000000.0
+
+/* ---------- Value parsers (static) ---------- */
+
+static int parse_uint(const char *s, unsigned int *out) {
+    if (!s || !isdigit((unsigned char)*s)) return -1;
+    char *end = NULL;
+    errno = 0;
+    unsigned long v = strtoul(s, &end, 10);
+    if (errno != 0 || *end != '\0' || v > (unsigned long)(unsigned int)-1) return -1;
+    *out = (unsigned int)v;
+    return 0;
+}
+
+/* Byte count with an optional K, M or G suffix. */
+static int parse_size(const char *s, size_t *out) {
+    if (!s || !isdigit((unsigned char)*s)) return -1;
+    char *end = NULL;
+    errno = 0;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (errno != 0) return -1;
+
+    unsigned long long mult = 1;
+    switch (toupper((unsigned char)*end)) {
+        case 'K': mult = 1ULL << 10; end++; break;
+        case 'M': mult = 1ULL << 20; end++; break;
+        case 'G': mult = 1ULL << 30; end++; break;
+        default: break;
+    }
+    if (*end == 'B' || *end == 'b') end++;
+    if (*end != '\0' || v > (unsigned long long)(size_t)-1 / mult) return -1;
+    *out = (size_t)(v * mult);
+    return 0;
+}
+
+static int parse_double(const char *s, double *out) {
+    if (!s || *s == '\0') return -1;
+    char *end = NULL;
+    errno = 0;
+    double v = strtod(s, &end);
+    if (errno != 0 || *end != '\0') return -1;
+    *out = v;
+    return 0;
+}
+
+static int parse_bool(const char *s, int *out) {
+    if (!s) return -1;
+    if (strcmp(s, "1") == 0 || strcmp(s, "true") == 0 || strcmp(s, "yes") == 0 ||
+        strcmp(s, "on") == 0) {
+        *out = 1;
+    } else if (strcmp(s, "0") == 0 || strcmp(s, "false") == 0 || strcmp(s, "no") == 0 ||
+               strcmp(s, "off") == 0) {
+        *out = 0;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/* Replace *dst with a copy of `s` ("" clears it). */
+static int set_string(char **dst, const char *s) {
+    char *copy = NULL;
+    if (s && *s) {
+        copy = strdup(s);
+        if (!copy) return -1;
+    }
+    free(*dst);
+    *dst = copy;
+    return 0;
+}
+
+static void free_features(LRConfig *cfg) {
+    for (size_t i = 0; i < cfg->n_features; i++) free(cfg->features[i]);
+    free(cfg->features);
+    cfg->features = NULL;
+    cfg->n_features = 0;
+}
+
+/* Split a comma-separated list into cfg->features ("" clears it). */
+static int set_features(LRConfig *cfg, const char *s) {
+    size_t n = 0;
+    if (*s) {
+        n = 1;
+        for (const char *p = s; *p; p++) n += (*p == ',');
+    }
+
+    char **list = n ? calloc(n, sizeof(char*)) : NULL;
+    if (n && !list) return -1;
+
+    const char *p = s;
+    for (size_t i = 0; i < n; i++) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        list[i] = malloc(len + 1);
+        if (!list[i]) {
+            for (size_t k = 0; k < i; k++) free(list[k]);
+            free(list);
+            return -1;
+        }
+        memcpy(list[i], p, len);
+        list[i][len] = '\0';
+        p = end ? end + 1 : p + len;
+    }
+
+    free_features(cfg);
+    cfg->features = list;
+    cfg->n_features = n;
+    return 0;
+}
+
+/* ---------- Key table ---------- */
+
+/* Setters return 0 on success, -1 for an invalid value. */
+typedef int (*config_setter)(LRConfig *cfg, const char *value);
+
+static int set_data(LRConfig *cfg, const char *v) { return set_string(&cfg->data_path, v); }
+static int set_target(LRConfig *cfg, const char *v) { return set_string(&cfg->target, v); }
+static int set_feature_list(LRConfig *cfg, const char *v) { return set_features(cfg, v); }
+static int set_checkpoint(LRConfig *cfg, const char *v) { return set_string(&cfg->checkpoint_path, v); }
+static int set_profile(LRConfig *cfg, const char *v) { return set_string(&cfg->profile_path, v); }
+static int set_dedup(LRConfig *cfg, const char *v) { return parse_bool(v, &cfg->dedup); }
+static int set_autotune(LRConfig *cfg, const char *v) { return parse_bool(v, &cfg->autotune); }
+static int set_threads(LRConfig *cfg, const char *v) { return parse_uint(v, &cfg->threads); }
+static int set_tuned_inputs(LRConfig *cfg, const char *v) { return parse_size(v, &cfg->tuned_inputs); }
+static int set_memory_budget(LRConfig *cfg, const char *v) { return parse_size(v, &cfg->memory_budget); }
+
+static int set_checkpoint_every(LRConfig *cfg, const char *v) {
+    return parse_uint(v, &cfg->checkpoint_every);
+}
+
+static int set_learning_rate(LRConfig *cfg, const char *v) {
+    double a;
+    if (parse_double(v, &a) != 0 || !(a > 0.0)) return -1;
+    cfg->learning_rate = a;
+    return 0;
+}
+
+static int set_iterations(LRConfig *cfg, const char *v) {
+    unsigned int n;
+    if (parse_uint(v, &n) != 0 || n == 0) return -1;
+    cfg->iterations = n;
+    return 0;
+}
+
+static int set_batch_size(LRConfig *cfg, const char *v) {
+    size_t n;
+    if (parse_size(v, &n) != 0 || n == 0) return -1;
+    cfg->batch_size = n;
+    return 0;
+}
+
+static int set_solver(LRConfig *cfg, const char *v) {
+    if (strcmp(v, "batch") == 0) cfg->solver = CONFIG_SOLVER_BATCH;
+    else if (strcmp(v, "minibatch") == 0) cfg->solver = CONFIG_SOLVER_MINIBATCH;
+    else return -1;
+    return 0;
+}
+
+static int set_pin(LRConfig *cfg, const char *v) {
+    if (strcmp(v, "none") == 0) cfg->pin = GD_PIN_NONE;
+    else if (strcmp(v, "core") == 0) cfg->pin = GD_PIN_CORE;
+    else if (strcmp(v, "node") == 0) cfg->pin = GD_PIN_NODE;
+    else return -1;
+    return 0;
+}
+
+static int set_placement(LRConfig *cfg, const char *v) {
+    if (strcmp(v, "shared") == 0) cfg->placement = GD_PLACE_SHARED;
+    else if (strcmp(v, "first-touch") == 0) cfg->placement = GD_PLACE_FIRST_TOUCH;
+    else return -1;
+    return 0;
+}
+
+static int set_precision(LRConfig *cfg, const char *v) {
+    if (strcmp(v, "double") != 0) return -1;
+    cfg->precision = CONFIG_PRECISION_DOUBLE;
+    return 0;
+}
+
+/* A kernel or block size from a later source replaces the tuned one, so the
+ * tuned width no longer applies. */
+static int set_kernel(LRConfig *cfg, const char *v) {
+    if (strcmp(v, "auto") == 0) cfg->kernel = GD_KERNEL_AUTO;
+    else if (strcmp(v, "rows") == 0) cfg->kernel = GD_KERNEL_ROWS;
+    else if (strcmp(v, "blocked") == 0) cfg->kernel = GD_KERNEL_BLOCKED;
+    else return -1;
+    cfg->tuned_inputs = 0;
+    return 0;
+}
+
+static int set_block_size(LRConfig *cfg, const char *v) {
+    if (parse_size(v, &cfg->block_bytes) != 0) return -1;
+    cfg->tuned_inputs = 0;
+    return 0;
+}
+
+static const struct {
+    const char *key;
+    config_setter set;
+    int is_flag;        /* may be given as a bare --key on the command line */
+} config_keys[] = {
+    { "data",             set_data,             0 },
+    { "target",           set_target,           0 },
+    { "features",         set_feature_list,     0 },
+    { "learning-rate",    set_learning_rate,    0 },
+    { "iterations",       set_iterations,       0 },
+    { "solver",           set_solver,           0 },
+    { "batch-size",       set_batch_size,       0 },
+    { "threads",          set_threads,          0 },
+    { "pin",              set_pin,              0 },
+    { "placement",        set_placement,        0 },
+    { "precision",        set_precision,        0 },
+    { "kernel",           set_kernel,           0 },
+    { "block-size",       set_block_size,       0 },
+    { "tuned-inputs",     set_tuned_inputs,     0 },
+    { "memory-budget",    set_memory_budget,    0 },
+    { "dedup",            set_dedup,            1 },
+    { "checkpoint",       set_checkpoint,       0 },
+    { "checkpoint-every", set_checkpoint_every, 0 },
+    { "profile",          set_profile,          0 },
+    { "autotune",         set_autotune,         1 },
+};
+
+#define CONFIG_N_KEYS (sizeof(config_keys) / sizeof(config_keys[0]))
+
+/* Find a key by name, treating '_' and '-' alike and ignoring case.
+ * Returns the table index or -1. */
+static int find_key(const char *name, size_t len) {
+    for (size_t k = 0; k < CONFIG_N_KEYS; k++) {
+        const char *key = config_keys[k].key;
+        if (strlen(key) != len) continue;
+        size_t i = 0;
+        for (; i < len; i++) {
+            char c = (char)tolower((unsigned char)name[i]);
+            if (c == '_') c = '-';
+            if (c != key[i]) break;
+        }
+        if (i == len) return (int)k;
+    }
+    return -1;
+}
+
+/* ---------- Sources (static) ---------- */
+
+static int load_env(LRConfig *cfg) {
+    for (size_t k = 0; k < CONFIG_N_KEYS; k++) {
+        char name[64] = "LR_";
+        size_t n = 3;
+        for (const char *p = config_keys[k].key; *p && n + 1 < sizeof(name); p++) {
+            name[n++] = (*p == '-') ? '_' : (char)toupper((unsigned char)*p);
+        }
+        name[n] = '\0';
+
+        const char *value = getenv(name);
+        if (value && config_set(cfg, config_keys[k].key, value, name) != 0) return -1;
+    }
+    return 0;
+}
+
+/* Apply --key=value options and positional arguments. --config and --help
+ * are handled by the caller. */
+static int load_cli(LRConfig *cfg, int argc, char *argv[]) {
+    int n_pos = 0;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strncmp(arg, "--", 2) != 0) {
+            /* <data> [target [feature...]] */
+            int r = 0;
+            if (n_pos == 0) r = config_set(cfg, "data", arg, "command line");
+            else if (n_pos == 1) r = config_set(cfg, "target", arg, "command line");
+            else if (n_pos == 2) r = set_features(cfg, "");
+            if (r != 0) return -1;
+
+            if (n_pos >= 2) {
+                char **list = realloc(cfg->features, (cfg->n_features + 1) * sizeof(char*));
+                char *copy = strdup(arg);
+                if (!list || !copy) {
+                    if (list) cfg->features = list;
+                    free(copy);
+                    fprintf(stderr, "config: memory allocation failed\n");
+                    return -1;
+                }
+                cfg->features = list;
+                cfg->features[cfg->n_features++] = copy;
+            }
+            n_pos++;
+            continue;
+        }
+
+        const char *name = arg + 2;
+        const char *eq = strchr(name, '=');
+        size_t len = eq ? (size_t)(eq - name) : strlen(name);
+        if (len == 6 && strncmp(name, "config", 6) == 0) continue;
+
+        int k = find_key(name, len);
+        if (k < 0) {
+            fprintf(stderr, "config: unknown option '%s'\n", arg);
+            return -1;
+        }
+        if (!eq && !config_keys[k].is_flag) {
+            fprintf(stderr, "config: option '%s' needs a value (--%s=...)\n",
+                    arg, config_keys[k].key);
+            return -1;
+        }
+        if (config_set(cfg, config_keys[k].key, eq ? eq + 1 : "1", "command line") != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Config file path from --config=PATH, else LR_CONFIG, else NULL. */
+static const char *find_config_path(int argc, char *argv[]) {
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--config=", 9) == 0) path = argv[i] + 9;
+    }
+    if (!path) path = getenv("LR_CONFIG");
+    return (path && *path) ? path : NULL;
+}
+
+/* Config file, environment and command line, in that order. Without an
+ * explicit profile path, CONFIG_DEFAULT_PROFILE is used. */
+static int apply_sources(LRConfig *cfg, int argc, char *argv[]) {
+    const char *file = find_config_path(argc, argv);
+    if (file && config_load_file(cfg, file) != 0) return -1;
+    if (load_env(cfg) != 0) return -1;
+    if (load_cli(cfg, argc, argv) != 0) return -1;
+    if (!cfg->profile_path && set_string(&cfg->profile_path, CONFIG_DEFAULT_PROFILE) != 0) {
+        fprintf(stderr, "config: memory allocation failed\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* ---------- Public API ---------- */
+
+void config_init(LRConfig *cfg) {
+    if (!cfg) return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->learning_rate = CONFIG_DEFAULT_LEARNING_RATE;
+    cfg->iterations = CONFIG_DEFAULT_ITERATIONS;
+    cfg->solver = CONFIG_SOLVER_BATCH;
+    cfg->batch_size = CONFIG_DEFAULT_BATCH_SIZE;
+    cfg->threads = 1;
+    cfg->pin = GD_PIN_NONE;
+    cfg->placement = GD_PLACE_SHARED;
+    cfg->precision = CONFIG_PRECISION_DOUBLE;
+    cfg->kernel = GD_KERNEL_AUTO;
+    cfg->block_bytes = GD_DEFAULT_BLOCK_BYTES;
+}
+
+int config_set(LRConfig *cfg, const char *key, const char *value, const char *origin) {
+    if (!cfg || !key || !value) return -1;
+    int k = find_key(key, strlen(key));
+    if (k < 0) {
+        fprintf(stderr, "config: unknown key '%s' (%s)\n", key, origin ? origin : "?");
+        return -1;
+    }
+    if (config_keys[k].set(cfg, value) != 0) {
+        fprintf(stderr, "config: invalid value '%s' for '%s' (%s)\n",
+                value, config_keys[k].key, origin ? origin : "?");
+        return -1;
+    }
+    return 0;
+}
+
+int config_load_file(LRConfig *cfg, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "config: cannot open '%s'\n", path);
+        return -1;
+    }
+
+    char line[4096];
+    unsigned int lineno = 0;
+    int result = 0;
+    while (result == 0 && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *eq = strchr(line, '=');
+        char *key = line;
+        while (isspace((unsigned char)*key)) key++;
+        if (*key == '\0') continue;
+
+        char origin[256];
+        snprintf(origin, sizeof(origin), "%s:%u", path, lineno);
+        if (!eq) {
+            fprintf(stderr, "config: expected 'key = value' (%s)\n", origin);
+            result = -1;
+            break;
+        }
+
+        char *key_end = eq;
+        while (key_end > key && isspace((unsigned char)key_end[-1])) key_end--;
+        *key_end = '\0';
+
+        char *value = eq + 1;
+        while (isspace((unsigned char)*value)) value++;
+        char *value_end = value + strlen(value);
+        while (value_end > value && isspace((unsigned char)value_end[-1])) value_end--;
+        *value_end = '\0';
+
+        result = config_set(cfg, key, value, origin);
+    }
+
+    fclose(f);
+    return result;
+}
+
+int config_load(LRConfig *cfg, int argc, char *argv[]) {
+    config_init(cfg);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) return 1;
+    }
+
+    /* The profile sits below every explicit source, but its path may itself
+       come from any of them: resolve everything once to find it. */
+    if (apply_sources(cfg, argc, argv) != 0) return -1;
+    if (cfg->autotune) return 0;
+
+    char *profile = strdup(cfg->profile_path);
+    if (!profile) {
+        fprintf(stderr, "config: memory allocation failed\n");
+        return -1;
+    }
+    FILE *probe = fopen(profile, "r");
+    if (!probe) {
+        /* not tuned yet */
+        free(profile);
+        return 0;
+    }
+    fclose(probe);
+
+    config_free(cfg);
+    config_init(cfg);
+    int r = config_load_file(cfg, profile);
+    free(profile);
+    if (r != 0) return -1;
+    return apply_sources(cfg, argc, argv);
+}
+
+void config_gd_options(const LRConfig *cfg, GDOptions *opts) {
+    gd_default_options(opts);
+    opts->threads = cfg->threads;
+    opts->pin = cfg->pin;
+    opts->placement = cfg->placement;
+    opts->kernel = cfg->kernel;
+    opts->block_bytes = cfg->block_bytes;
+    opts->batch_size = cfg->solver == CONFIG_SOLVER_MINIBATCH ? cfg->batch_size : 0;
+    opts->checkpoint_interval = cfg->checkpoint_every;
+}
+
+int config_match_profile(LRConfig *cfg, const CSVData *data) {
+    size_t inputs = data->cols - 1;
+    if (cfg->tuned_inputs == 0 || cfg->tuned_inputs == inputs) return 0;
+
+    printf("Note: profile '%s' was tuned for %zu inputs, the data has %zu; "
+           "using kernel=auto and the default block size\n",
+           cfg->profile_path ? cfg->profile_path : CONFIG_DEFAULT_PROFILE,
+           cfg->tuned_inputs, inputs);
+    cfg->kernel = GD_KERNEL_AUTO;
+    cfg->block_bytes = GD_DEFAULT_BLOCK_BYTES;
+    cfg->tuned_inputs = 0;
+    return 1;
+}
+
+int config_check_memory(const LRConfig *cfg, const CSVData *data, GDOptions *opts) {
+    if (cfg->memory_budget == 0) return 0;
+
+    size_t rows = data->rows;
+    size_t data_bytes = rows * data->cols * sizeof(double) + rows * sizeof(double*);
+    if (data->weights) data_bytes += rows * sizeof(double);
+    size_t buffers = gd_working_set(data, opts);
+
+    if (data_bytes + buffers > cfg->memory_budget && opts->placement == GD_PLACE_FIRST_TOUCH) {
+        GDOptions shared = *opts;
+        shared.placement = GD_PLACE_SHARED;
+        size_t shared_buffers = gd_working_set(data, &shared);
+        if (data_bytes + shared_buffers <= cfg->memory_budget) {
+            printf("Note: first-touch placement exceeds the memory budget, using shared placement\n");
+            opts->placement = GD_PLACE_SHARED;
+            return 0;
+        }
+        buffers = shared_buffers;
+    }
+    if (data_bytes + buffers > cfg->memory_budget) {
+        fprintf(stderr, "config: training needs %zu bytes (%zu data, %zu worker buffers), "
+                        "memory budget is %zu\n",
+                data_bytes + buffers, data_bytes, buffers, cfg->memory_budget);
+        return -1;
+    }
+    return 0;
+}
+
+/* ---------- Autotune ---------- */
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Seconds per iteration of one configuration, or a negative value on failure. */
+static double time_candidate(const CSVData *sample, const GDOptions *opts, unsigned int iterations) {
+    LinearRegression *lr = lr_create(sample->cols);
+    if (!lr) return -1.0;
+
+    /* A tiny step keeps theta finite however many iterations run. */
+    double start = now_sec();
+    int r = gradient_descent_ex(lr, sample, 1e-9, iterations, opts, NULL);
+    double elapsed = now_sec() - start;
+
+    lr_free(lr);
+    return r == 0 ? elapsed / iterations : -1.0;
+}
+
+int config_autotune(LRConfig *cfg, const CSVData *data) {
+    static const size_t block_sizes[] = {
+        32 << 10, 64 << 10, 128 << 10, 256 << 10, 512 << 10, 1 << 20, 2 << 20
+    };
+    static const GDKernel kernels[] = { GD_KERNEL_ROWS, GD_KERNEL_BLOCKED };
+    static const char *kernel_names[] = { "auto", "rows", "blocked" };
+
+    if (!cfg || !data || data->rows == 0) return -1;
+
+    Topology topo;
+    if (topology_detect(&topo) != 0) return -1;
+    unsigned int max_threads = (unsigned int)topology_cpu_count(&topo);
+    size_t n_nodes = topo.n_nodes;
+    topology_free(&topo);
+    if (max_threads == 0) max_threads = 1;
+
+    /* Tune on a prefix of the real data: the kernel choice depends on its width. */
+    CSVData sample = *data;
+    if (sample.rows > AUTOTUNE_MAX_ROWS) sample.rows = AUTOTUNE_MAX_ROWS;
+    sample.col_names = NULL;
+
+    double work = (double)sample.rows * (double)sample.cols;
+    unsigned int iterations = (unsigned int)(AUTOTUNE_WORK / work);
+    if (iterations < 3) iterations = 3;
+    if (iterations > 200) iterations = 200;
+
+    printf("Autotune: %zu rows x %zu features, %u CPU(s) on %zu node(s), %u iterations per run\n",
+           sample.rows, sample.cols - 1, max_threads, n_nodes, iterations);
+
+    GDOptions opts;
+    config_gd_options(cfg, &opts);
+    opts.batch_size = 0;
+    opts.checkpoint_interval = 0;
+
+    double best = -1.0;
+    GDKernel best_kernel = GD_KERNEL_AUTO;
+    unsigned int best_threads = 1;
+    size_t best_block = GD_DEFAULT_BLOCK_BYTES;
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        /* Thread counts 1, 2, 4, ... plus every available CPU. */
+        for (unsigned int t = 1;; t = t * 2 < max_threads ? t * 2 : max_threads) {
+            size_t n_blocks = kernels[k] == GD_KERNEL_BLOCKED
+                              ? sizeof(block_sizes) / sizeof(block_sizes[0]) : 1;
+            for (size_t b = 0; b < n_blocks; b++) {
+                opts.kernel = kernels[k];
+                opts.threads = t;
+                opts.block_bytes = kernels[k] == GD_KERNEL_BLOCKED
+                                   ? block_sizes[b] : GD_DEFAULT_BLOCK_BYTES;
+
+                time_candidate(&sample, &opts, 1);  /* warm-up */
+                double sec = time_candidate(&sample, &opts, iterations);
+                if (sec < 0.0) continue;
+
+                printf("  kernel=%-7s threads=%-3u block-size=%-8zu %10.3f us/iter\n",
+                       kernel_names[opts.kernel], t, opts.block_bytes, sec * 1e6);
+                if (best < 0.0 || sec < best) {
+                    best = sec;
+                    best_kernel = opts.kernel;
+                    best_threads = t;
+                    best_block = opts.block_bytes;
+                }
+            }
+            if (t == max_threads) break;
+        }
+    }
+
+    if (best < 0.0) {
+        fprintf(stderr, "config: autotune could not run any configuration\n");
+        return -1;
+    }
+
+    cfg->kernel = best_kernel;
+    cfg->threads = best_threads;
+    cfg->block_bytes = best_block;
+    cfg->tuned_inputs = sample.cols - 1;
+    printf("Autotune: best kernel=%s threads=%u block-size=%zu (%.3f us/iter)\n",
+           kernel_names[best_kernel], best_threads, best_block, best * 1e6);
+
+    const char *path = cfg->profile_path ? cfg->profile_path : CONFIG_DEFAULT_PROFILE;
+    if (config_save_profile(cfg, path) != 0) return -1;
+    printf("Autotune: profile saved to '%s'\n", path);
+    return 0;
+}
+
+int config_save_profile(const LRConfig *cfg, const char *path) {
+    static const char *kernel_names[] = { "auto", "rows", "blocked" };
+
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror("config: fopen");
+        return -1;
+    }
+    fprintf(f, "# linear_regression tuned profile (linalg backend: %s)\n", linalg_backend_name());
+    fprintf(f, "kernel = %s\n", kernel_names[cfg->kernel]);
+    fprintf(f, "threads = %u\n", cfg->threads);
+    fprintf(f, "block-size = %zu\n", cfg->block_bytes);
+    /* after kernel and block-size: setting those clears it */
+    if (cfg->tuned_inputs) fprintf(f, "tuned-inputs = %zu\n", cfg->tuned_inputs);
+    if (fclose(f) != 0) {
+        perror("config: fclose");
+        return -1;
+    }
+    return 0;
+}
+
+void config_usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--key=value...] <csv_file> [target_column [feature_column...]]\n"
+            "\n"
+            "Keys (also LR_<KEY> environment variables and config file entries):\n"
+            "  --config=PATH               config file with 'key = value' lines\n"
+            "  --learning-rate=A           step size (default %g)\n"
+            "  --iterations=N              gradient steps (default %d)\n"
+            "  --solver=batch|minibatch    full batch or --batch-size rows per step\n"
+            "  --batch-size=N              rows per mini-batch step (default %d)\n"
+            "  --threads=N                 training workers, 0 = one per CPU (default 1)\n"
+            "  --pin=none|core|node        worker thread pinning\n"
+            "  --placement=shared|first-touch\n"
+            "                              where workers read their rows from\n"
+            "  --precision=double          floating-point type\n"
+            "  --kernel=auto|rows|blocked  gradient kernel\n"
+            "  --block-size=BYTES          row block size of the blocked kernel\n"
+            "  --memory-budget=BYTES       limit for loaded rows and training buffers, 0 = none\n"
+            "  --dedup                     compact duplicate rows into weighted samples\n"
+            "  --checkpoint=PATH           write checkpoints and resume from them\n"
+            "  --checkpoint-every=N        iterations between checkpoints\n"
+            "  --profile=PATH              tuned profile to load, or save with --autotune\n"
+            "                              (default %s)\n"
+            "  --autotune                  benchmark this host and save a profile\n",
+            prog, CONFIG_DEFAULT_LEARNING_RATE, CONFIG_DEFAULT_ITERATIONS,
+            CONFIG_DEFAULT_BATCH_SIZE, CONFIG_DEFAULT_PROFILE);
+}
+
+void config_free(LRConfig *cfg) {
+    if (!cfg) return;
+    free(cfg->data_path);
+    free(cfg->target);
+    free(cfg->checkpoint_path);
+    free(cfg->profile_path);
+    free_features(cfg);
+    cfg->data_path = NULL;
+    cfg->target = NULL;
+    cfg->checkpoint_path = NULL;
+    cfg->profile_path = NULL;
+}
@@ -1,12 +1,14 @@
 #define _POSIX_C_SOURCE 200809L 
 
 #include "../include/csv_reader.h"
+#include "../include/utils.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#include <stdint.h>
 
 /* ---------- Helpers (static) ---------- */
 
@@ -121,83 +123,239 @@ static char *extract_next_token(const char **sp) {
     return buf;
 }
 
-/* Check whether a line contains only numeric tokens. Returns 1 if all tokens
- * parse as numbers (using strtod), 0 otherwise. On success, *out_n_tokens
- * receives the number of tokens (if out_n_tokens != NULL).
+/* A token counts as numeric when strtod() consumes at least its first character. */
+static int is_numeric_token(const char *tok) {
+    if (tok[0] == '\0') return 0;
+    char *endptr = NULL;
+    errno = 0;
+    strtod(tok, &endptr);
+    return endptr != tok;
+}
+
+/* Advance *sp past the next CSV field without copying or converting it.
+ * Field boundaries follow extract_next_token() exactly, so skipped and
+ * extracted columns stay aligned.
  *
- * This function does not leak memory (extract_next_token allocations are freed).
+ * Returns 1 if a field was skipped, 0 at end-of-line.
  */
-static int is_line_numeric(const char *line, size_t *out_n_tokens) {
+static int skip_next_field(const char **sp) {
+    const char *p = *sp;
+    while (*p && *p != '\n' && isspace((unsigned char)*p)) p++;
+    if (*p == '\0' || *p == '\n' || *p == '\r') { *sp = p; return 0; }
+
+    if (*p == '"') {
+        p++;
+        while (*p && *p != '"') {
+            if (*p == '\\' && *(p + 1) != '\0') p++;
+            p++;
+        }
+        if (*p == '"') p++;
+        while (*p && *p != ',' && *p != '\n' && isspace((unsigned char)*p)) p++;
+    } else {
+        while (*p && *p != ',' && *p != '\n' && *p != '\r') p++;
+    }
+    if (*p == ',') p++;
+
+    *sp = p;
+    return 1;
+}
+
+/* Split a line into its raw tokens (used for the header). On success returns 0
+ * and sets *out_tokens (malloc'd array of malloc'd strings) and *out_count.
+ * Returns -1 on memory allocation failure.
+ */
+static int split_line_tokens(const char *line, char ***out_tokens, size_t *out_count) {
     const char *p = line;
-    size_t count = 0;
+    size_t cap = 8;
+    size_t n = 0;
+    char **toks = malloc(cap * sizeof(char*));
+    if (!toks) return -1;
 
     while (1) {
         char *tok = extract_next_token(&p);
         if (!tok) break;
-        if (tok[0] == '\0') { free(tok); return 0; } 
-        char *endptr = NULL;
-        errno = 0;
-        strtod(tok, &endptr);
-        if (endptr == tok) { free(tok); return 0; } 
-        free(tok);
-        count++;
+        if (n >= cap) {
+            cap *= 2;
+            char **tmp = realloc(toks, cap * sizeof(char*));
+            if (!tmp) {
+                free(tok);
+                for (size_t i = 0; i < n; i++) free(toks[i]);
+                free(toks);
+                return -1;
+            }
+            toks = tmp;
+        }
+        toks[n++] = tok;
     }
 
-    if (out_n_tokens) *out_n_tokens = count;
-    return 1;
+    *out_tokens = toks;
+    *out_count = n;
+    return 0;
+}
+
+static void free_tokens(char **toks, size_t n) {
+    if (!toks) return;
+    for (size_t i = 0; i < n; i++) free(toks[i]);
+    free(toks);
+}
+
+/* Resolve a column selector against the source header. A selector matching a
+ * header name wins; otherwise an all-digit selector is taken as a 0-based index.
+ *
+ * Returns the source column index, or -1 if the selector matches nothing.
+ */
+static long resolve_column(const char *selector, char **names, size_t total_cols) {
+    if (!selector || selector[0] == '\0') return -1;
+
+    if (names) {
+        for (size_t c = 0; c < total_cols; c++) {
+            if (strcmp(names[c], selector) == 0) return (long)c;
+        }
+    }
+
+    for (const char *s = selector; *s; s++) {
+        if (!isdigit((unsigned char)*s)) return -1;
+    }
+    errno = 0;
+    unsigned long idx = strtoul(selector, NULL, 10);
+    if (errno != 0 || idx >= total_cols) return -1;
+    return (long)idx;
+}
+
+/* Build the source-column -> output-slot map for `schema`. Features occupy
+ * slots 0..k-1 in selection order and the target takes slot k; unselected
+ * columns map to -1.
+ *
+ * Returns the number of output columns (k + 1), or 0 on error (message printed
+ * if `report` is set).
+ */
+static size_t build_projection(const CSVSchema *schema, char **names,
+                               size_t total_cols, long *slot, int report) {
+    for (size_t c = 0; c < total_cols; c++) slot[c] = -1;
+
+    long target;
+    if (schema && schema->target) {
+        target = resolve_column(schema->target, names, total_cols);
+        if (target < 0) {
+            if (report) fprintf(stderr, "csv_read: target column '%s' not found\n", schema->target);
+            return 0;
+        }
+    } else {
+        target = (long)total_cols - 1;
+    }
+
+    size_t k = 0;
+    if (schema && schema->features && schema->n_features > 0) {
+        for (size_t i = 0; i < schema->n_features; i++) {
+            long c = resolve_column(schema->features[i], names, total_cols);
+            if (c < 0) {
+                if (report) fprintf(stderr, "csv_read: feature column '%s' not found\n",
+                                    schema->features[i] ? schema->features[i] : "(null)");
+                return 0;
+            }
+            if (c == target || slot[c] >= 0) {
+                if (report) fprintf(stderr, "csv_read: column '%s' selected more than once\n",
+                                    schema->features[i]);
+                return 0;
+            }
+            slot[c] = (long)k++;
+        }
+    } else {
+        for (size_t c = 0; c < total_cols; c++) {
+            if ((long)c != target) slot[c] = (long)k++;
+        }
+    }
+
+    if (k == 0) {
+        if (report) fprintf(stderr, "csv_read: no feature columns selected\n");
+        return 0;
+    }
+
+    slot[target] = (long)k;
+    return k + 1;
 }
 
-/* Parse line into an array of doubles. On success returns 0 and sets *out_values
- * (malloc'd array) and *out_count. Caller must free *out_values.
+/* Decide whether the first line `toks` is a header, looking only at the
+ * columns `schema` selects (unselected columns may hold text in data rows):
+ *   - read as header names, the selectors resolve and a selected field is
+ *     not numeric: header;
+ *   - read as 0-based indices, the selectors resolve and every selected
+ *     field is numeric: data.
+ * Returns 1 for a header, 0 for data, -1 if neither reading fits. `slot` is
+ * scratch space of length n.
+ */
+static int detect_header(const CSVSchema *schema, char **toks, size_t n, long *slot) {
+    if (build_projection(schema, toks, n, slot, 0) != 0) {
+        for (size_t c = 0; c < n; c++) {
+            if (slot[c] >= 0 && !is_numeric_token(toks[c])) return 1;
+        }
+    }
+    if (build_projection(schema, NULL, n, slot, 0) != 0) {
+        for (size_t c = 0; c < n; c++) {
+            if (slot[c] >= 0 && !is_numeric_token(toks[c])) return -1;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+/* Parse the selected fields of `line` into `out` (length = number of output
+ * columns) according to `slot`. Unselected fields are skipped without being
+ * converted, so they may hold arbitrary text.
  *
  * Returns:
- *   0   success
+ *   0   success (*out_fields receives the number of source fields seen)
  *  -1   memory allocation failure
- *  -2   empty token found (malformed)
- *  -3   non-numeric token found
+ *  -2   empty token found in a selected field (malformed)
+ *  -3   non-numeric token found in a selected field
  */
-static int parse_line_to_doubles(const char *line, double **out_values, size_t *out_count) {
+static int parse_projected_line(const char *line, const long *slot, size_t total_cols,
+                                double *out, size_t *out_fields) {
     const char *p = line;
-    size_t cap = 8;
-    size_t n = 0;
-    double *vals = malloc(cap * sizeof(double));
-    if (!vals) return -1;
+    size_t c = 0;
 
     while (1) {
+        if (c >= total_cols || slot[c] < 0) {
+            if (!skip_next_field(&p)) break;
+            c++;
+            continue;
+        }
+
         char *tok = extract_next_token(&p);
-        if (!tok) break;
-        if (tok[0] == '\0') { free(tok); free(vals); return -2; }
+        if (!tok) {
+            /* NULL is also returned on malloc failure; tell the two apart */
+            while (*p && *p != '\n' && isspace((unsigned char)*p)) p++;
+            if (*p == '\0' || *p == '\n' || *p == '\r') break;
+            return -1;
+        }
+        if (tok[0] == '\0') { free(tok); return -2; }
 
         errno = 0;
         char *endptr = NULL;
         double v = strtod(tok, &endptr);
-        if (endptr == tok) { free(tok); free(vals); return -3; }
-
-        if (n >= cap) {
-            cap *= 2;
-            double *tmp = realloc(vals, cap * sizeof(double));
-            if (!tmp) { free(tok); free(vals); return -1; }
-            vals = tmp;
-        }
-        vals[n++] = v;
+        if (endptr == tok) { free(tok); return -3; }
         free(tok);
-    }
 
-    if (n == 0) {
-        free(vals);
-        *out_values = NULL;
-        *out_count = 0;
-        return 0;
+        out[slot[c]] = v;
+        c++;
     }
 
-    double *shr = realloc(vals, n * sizeof(double));
-    if (shr) vals = shr;
-
-    *out_values = vals;
-    *out_count = n;
+    *out_fields = c;
     return 0;
 }
+
+static int line_is_blank(const char *line) {
+    for (const char *t = line; *t; t++) {
+        if (!isspace((unsigned char)*t)) return 0;
+    }
+    return 1;
+}
+
 CSVData* csv_read(const char *filename) {
+    return csv_read_schema(filename, NULL);
+}
+
+CSVData* csv_read_schema(const char *filename, const CSVSchema *schema) {
     if (!filename) {
         fprintf(stderr, "csv_read: filename is NULL\n");
         return NULL;
@@ -209,140 +367,341 @@ CSVData* csv_read(const char *filename) {
         return NULL;
     }
 
+    /* First non-empty line decides the source layout: a non-numeric line is
+       the header, otherwise it is already the first data row. */
+    char *line = NULL;
+    while ((line = read_line(f)) != NULL) {
+        if (!line_is_blank(line)) break;
+        free(line);
+    }
+    if (!line) {
+        fprintf(stderr, "csv_read: no numeric data rows found in file\n");
+        fclose(f);
+        return NULL;
+    }
+
+    char **header = NULL;
+    size_t total_cols = 0;
+    if (split_line_tokens(line, &header, &total_cols) != 0) {
+        fprintf(stderr, "csv_read: memory error parsing header\n");
+        free(line);
+        fclose(f);
+        return NULL;
+    }
+
+    if (total_cols == 0) {
+        fprintf(stderr, "csv_read: first line has no columns\n");
+        free_tokens(header, total_cols);
+        free(line);
+        fclose(f);
+        return NULL;
+    }
+
+    long *slot = malloc(total_cols * sizeof(long));
     CSVData *csv = malloc(sizeof(CSVData));
-    if (!csv) {
+    if (!slot || !csv) {
+        fprintf(stderr, "csv_read: memory allocation failed\n");
+        free(slot);
+        free(csv);
+        free_tokens(header, total_cols);
+        free(line);
+        fclose(f);
+        return NULL;
+    }
+
+    /* A first line that is neither is rejected rather than guessed: taking a
+       data row for a header would silently drop it. */
+    int has_header = detect_header(schema, header, total_cols, slot);
+    if (has_header < 0) {
+        if (build_projection(schema, header, total_cols, slot, 1) != 0) {
+            fprintf(stderr, "csv_read: first line is neither a header nor a numeric row "
+                            "in the selected columns\n");
+        }
+        free(slot);
+        free(csv);
+        free_tokens(header, total_cols);
+        free(line);
         fclose(f);
         return NULL;
     }
+    if (has_header) {
+        free(line);
+        line = NULL;
+    } else {
+        free_tokens(header, total_cols);
+        header = NULL;
+    }
+    /* Row pointers are built once loading is done; `values` may move until then. */
     csv->data = NULL;
+    csv->values = NULL;
     csv->rows = 0;
-    csv->cols = 0;
+    csv->col_names = NULL;
+    csv->weights = NULL;
+    csv->cols = build_projection(schema, header, total_cols, slot, 1);
+
+    /* Under a byte limit the storage never grows past the rows it allows. */
+    size_t max_rows = (size_t)-1;
+    if (schema && schema->max_bytes && csv->cols != 0) {
+        max_rows = schema->max_bytes / (csv->cols * sizeof(double) + sizeof(double*));
+    }
 
-    size_t rows_cap = 16;
-    csv->data = malloc(rows_cap * sizeof(double*));
-    if (!csv->data) {
-        free(csv);
+    size_t rows_cap = max_rows < 16 ? max_rows : 16;
+    if (rows_cap == 0) {
+        fprintf(stderr, "csv_read: a single row exceeds the limit of %zu bytes\n",
+                schema->max_bytes);
+        free(slot);
+        free_tokens(header, total_cols);
+        free(line);
         fclose(f);
+        csv_free(csv);
         return NULL;
     }
+    if (csv->cols != 0) {
+        csv->values = malloc(rows_cap * csv->cols * sizeof(double));
+        if (!csv->values) fprintf(stderr, "csv_read: memory allocation failed\n");
+    }
 
-    char *line = NULL;
-    int header_skipped = 0;
+    if (csv->cols == 0 || !csv->values) {
+        free(slot);
+        free_tokens(header, total_cols);
+        free(line);
+        fclose(f);
+        csv_free(csv);
+        return NULL;
+    }
 
-    while ((line = read_line(f)) != NULL) {
-        int only_ws = 1;
-        for (const char *t = line; *t; t++) {
-            if (!isspace((unsigned char)*t)) { only_ws = 0; break; }
+    if (has_header) {
+        csv->col_names = calloc(csv->cols, sizeof(char*));
+        if (!csv->col_names) {
+            fprintf(stderr, "csv_read: memory allocation failed\n");
+            free(slot);
+            free_tokens(header, total_cols);
+            fclose(f);
+            csv_free(csv);
+            return NULL;
+        }
+        /* Hand selected names over to the output; the rest are dropped. */
+        for (size_t c = 0; c < total_cols; c++) {
+            if (slot[c] >= 0) {
+                csv->col_names[slot[c]] = header[c];
+                header[c] = NULL;
+            }
         }
-        if (only_ws) { free(line); continue; }
+    }
+    free_tokens(header, total_cols);
+
+    /* When the first line was data, it is consumed here before the loop reads more. */
+    if (!line) line = read_line(f);
 
-        size_t tokens = 0;
-        if (is_line_numeric(line, &tokens)) {
-            double *vals = NULL;
-            size_t cnt = 0;
-            int r = parse_line_to_doubles(line, &vals, &cnt);
-            free(line);
+    for (; line != NULL; line = read_line(f)) {
+        if (line_is_blank(line)) { free(line); continue; }
 
-            if (r != 0) {
-                fprintf(stderr, "csv_read: failed parsing first data line\n");
+        if (csv->rows >= rows_cap) {
+            if (rows_cap == max_rows) {
+                fprintf(stderr, "csv_read: data exceeds the limit of %zu bytes\n",
+                        schema->max_bytes);
+                free(line);
+                free(slot);
                 fclose(f);
-                free(csv->data);
-                free(csv);
+                csv_free(csv);
                 return NULL;
             }
-
-            csv->cols = cnt;
-            csv->data[csv->rows++] = vals;
-            break; 
-        } else {
-            free(line);
-            header_skipped = 1;
-            break;
-        }
-    }
-
-    while ((line = read_line(f)) != NULL) {
-        int only_ws = 1;
-        for (const char *t = line; *t; t++) {
-            if (!isspace((unsigned char)*t)) { only_ws = 0; break; }
+            rows_cap = rows_cap > max_rows / 2 ? max_rows : rows_cap * 2;
+            double *tmp = realloc(csv->values, rows_cap * csv->cols * sizeof(double));
+            if (!tmp) {
+                fprintf(stderr, "csv_read: memory error parsing data row\n");
+                free(line);
+                free(slot);
+                fclose(f);
+                csv_free(csv);
+                return NULL;
+            }
+            csv->values = tmp;
         }
-        if (only_ws) { free(line); continue; }
 
-        double *vals = NULL;
-        size_t cnt = 0;
-        int r = parse_line_to_doubles(line, &vals, &cnt);
+        double *vals = csv->values + csv->rows * csv->cols;
+        size_t fields = 0;
+        int r = parse_projected_line(line, slot, total_cols, vals, &fields);
         free(line);
 
-        if (r == -2) {
+        if (r == 0 && fields == 0) continue;
+
+        if (r == 0 && fields != total_cols) {
+            fprintf(stderr, "csv_read: inconsistent column count: expected %zu, got %zu\n",
+                    total_cols, fields);
+            r = -4;
+        } else if (r == -2) {
             fprintf(stderr, "csv_read: empty token encountered in data\n");
-            fclose(f);
-            csv_free(csv);
-            return NULL;
         } else if (r == -3) {
             fprintf(stderr, "csv_read: non-numeric token encountered in data\n");
-            fclose(f);
-            csv_free(csv);
-            return NULL;
         } else if (r != 0) {
             fprintf(stderr, "csv_read: memory error parsing data row\n");
-            fclose(f);
-            csv_free(csv);
-            return NULL;
-        }
-
-        if (cnt == 0) {
-            free(vals); 
-            continue;
         }
 
-        if (csv->cols == 0) {
-            csv->cols = cnt;
-        } else if (cnt != csv->cols) {
-            fprintf(stderr, "csv_read: inconsistent column count: expected %zu, got %zu\n",
-                    csv->cols, cnt);
-            free(vals);
+        if (r != 0) {
+            free(slot);
             fclose(f);
             csv_free(csv);
             return NULL;
         }
 
-        if (csv->rows >= rows_cap) {
-            rows_cap *= 2;
-            double **tmp = realloc(csv->data, rows_cap * sizeof(double*));
-            if (!tmp) {
-                free(vals);
-                fclose(f);
-                csv_free(csv);
-                return NULL;
-            }
-            csv->data = tmp;
-        }
-        csv->data[csv->rows++] = vals;
+        csv->rows++;
     }
 
+    free(slot);
     fclose(f);
 
     if (csv->rows == 0) {
         fprintf(stderr, "csv_read: no numeric data rows found in file\n");
-        free(csv->data);
-        free(csv);
+        csv_free(csv);
         return NULL;
     }
 
-    double **shr = realloc(csv->data, csv->rows * sizeof(double*));
-    if (shr) csv->data = shr;
+    double *shr = realloc(csv->values, csv->rows * csv->cols * sizeof(double));
+    if (shr) csv->values = shr;
+
+    csv->data = malloc(csv->rows * sizeof(double*));
+    if (!csv->data) {
+        fprintf(stderr, "csv_read: memory allocation failed\n");
+        csv_free(csv);
+        return NULL;
+    }
+    for (size_t i = 0; i < csv->rows; ++i) {
+        csv->data[i] = csv->values + i * csv->cols;
+    }
 
     return csv;
 }
 
 
+/* FNV-1a over the bit patterns of a row. -0.0 is hashed as 0.0 so that rows
+ * comparing equal always hash equally. */
+static uint64_t hash_row(const double *row, size_t cols) {
+    uint64_t h = UTILS_HASH_INIT;
+    for (size_t j = 0; j < cols; j++) {
+        double v = (row[j] == 0.0) ? 0.0 : row[j];
+        h = utils_hash_bytes(&v, sizeof(double), h);
+    }
+    return h;
+}
+
+static int rows_equal(const double *a, const double *b, size_t cols) {
+    for (size_t j = 0; j < cols; j++) {
+        if (a[j] != b[j]) return 0;
+    }
+    return 1;
+}
+
+long csv_compact_duplicates(CSVData *csv) {
+    if (!csv || !csv->data || csv->rows == 0) return 0;
+
+    size_t m = csv->rows;
+    size_t cols = csv->cols;
+    size_t cap = 16;
+    while (cap < 2 * m) cap <<= 1;
+
+    /* table: open-addressing set of first occurrences (source row index).
+       out_of: output row each source row is merged into. */
+    size_t *table = malloc(cap * sizeof(size_t));
+    size_t *out_of = malloc(m * sizeof(size_t));
+    double *weights = malloc(m * sizeof(double));
+    if (!table || !out_of || !weights) {
+        fprintf(stderr, "csv_compact_duplicates: memory allocation failed\n");
+        free(table);
+        free(out_of);
+        free(weights);
+        return -1;
+    }
+    for (size_t s = 0; s < cap; s++) table[s] = SIZE_MAX;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < m; i++) {
+        const double *row = csv->data[i];
+        double w = csv->weights ? csv->weights[i] : 1.0;
+        size_t slot = (size_t)hash_row(row, cols) & (cap - 1);
+
+        while (table[slot] != SIZE_MAX && !rows_equal(csv->data[table[slot]], row, cols)) {
+            slot = (slot + 1) & (cap - 1);
+        }
+
+        if (table[slot] == SIZE_MAX) {
+            table[slot] = i;
+            out_of[i] = kept;
+            weights[kept++] = w;
+        } else {
+            out_of[i] = out_of[table[slot]];
+            weights[out_of[i]] += w;
+        }
+    }
+    free(table);
+
+    /* First occurrences receive increasing output indices, so a row is kept
+       exactly when its output index is the next free slot. Output slots never
+       run ahead of the source position, so rows can be moved in place. */
+    size_t k = 0;
+    for (size_t i = 0; i < m; i++) {
+        if (out_of[i] == k) {
+            if (csv->values) {
+                memmove(csv->values + k * cols, csv->data[i], cols * sizeof(double));
+            } else {
+                csv->data[k] = csv->data[i];
+            }
+            k++;
+        } else if (!csv->values) {
+            free(csv->data[i]);
+        }
+    }
+    free(out_of);
+
+    if (csv->values) {
+        double *shr = realloc(csv->values, kept * cols * sizeof(double));
+        if (shr) csv->values = shr;
+        for (size_t i = 0; i < kept; i++) {
+            csv->data[i] = csv->values + i * cols;
+        }
+    }
+    double **shr_rows = realloc(csv->data, kept * sizeof(double*));
+    if (shr_rows) csv->data = shr_rows;
+    double *shr_w = realloc(weights, kept * sizeof(double));
+    if (shr_w) weights = shr_w;
+
+    free(csv->weights);
+    csv->weights = weights;
+    csv->rows = kept;
+    return (long)(m - kept);
+}
+
+uint64_t csv_fingerprint(const CSVData *csv) {
+    if (!csv) return 0;
+    uint64_t h = UTILS_HASH_INIT;
+    uint64_t shape[2] = { csv->rows, csv->cols };
+    h = utils_hash_bytes(shape, sizeof(shape), h);
+    for (size_t i = 0; i < csv->rows; i++) {
+        h = utils_hash_bytes(csv->data[i], csv->cols * sizeof(double), h);
+    }
+    if (csv->weights) {
+        h = utils_hash_bytes(csv->weights, csv->rows * sizeof(double), h);
+    }
+    return h;
+}
+
 void csv_free(CSVData *csv) {
     if (!csv) return;
-    if (csv->data) {
+    if (csv->values) {
+        /* rows point into the contiguous block */
+        free(csv->values);
+    } else if (csv->data) {
         for (size_t i = 0; i < csv->rows; ++i) {
             free(csv->data[i]);
         }
-        free(csv->data);
+    }
+    free(csv->data);
+    free(csv->weights);
+    if (csv->col_names) {
+        for (size_t j = 0; j < csv->cols; ++j) {
+            free(csv->col_names[j]);
+        }
+        free(csv->col_names);
     }
     free(csv);
 }
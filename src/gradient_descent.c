@@ -1,13 +1,392 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "../include/gradient_descent.h"
+#include "../include/kernels.h"
+#include "../include/linalg.h"
+#include "../include/topology.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
+#include <pthread.h>
+
+/* Add the unscaled gradient over `m` rows of the row-major matrix `x`
+ * (leading dimension `ld`, features then target) to `grad`, one row block at
+ * a time:
+ *   e_b     = (X_b * w + theta[0] - y_b) .* weights_b
+ *   grad_w += X_b^T * e_b,  grad[0] += sum(e_b)
+ * `weights` may be NULL (all 1). `err` must hold `block` doubles.
+ */
+static void gradient_blocked(const double *theta, const double *x, size_t ld,
+                             const double *weights, size_t m, size_t n_inputs,
+                             size_t block, double *err, double *grad) {
+    for (size_t i0 = 0; i0 < m; i0 += block) {
+        size_t mb = (m - i0 < block) ? m - i0 : block;
+        const double *xb = x + i0 * ld;
+
+        for (size_t i = 0; i < mb; ++i) {
+            err[i] = theta[0] - xb[i * ld + n_inputs];
+        }
+        linalg_gemv(mb, n_inputs, 1.0, xb, ld, theta + 1, 1.0, err);
+        if (weights) {
+            for (size_t i = 0; i < mb; ++i) {
+                err[i] *= weights[i0 + i];
+            }
+        }
+
+        double sum = 0.0;
+        for (size_t i = 0; i < mb; ++i) {
+            sum += err[i];
+        }
+        grad[0] += sum;
+        linalg_gemv_t(mb, n_inputs, 1.0, xb, ld, err, 1.0, grad + 1);
+    }
+}
+
+/* ---------- Workers ---------- */
+
+typedef struct GDContext GDContext;
+
+/* One training worker. It owns a contiguous block of rows and a private
+ * gradient buffer; all its buffers are allocated from its own thread. */
+typedef struct {
+    GDContext *ctx;
+    size_t index;
+    size_t node;            /* index into the topology */
+    int cpu;                /* CPU for GD_PIN_CORE */
+    size_t row_begin;
+    size_t row_end;
+    double *local;          /* private copy of the rows, NULL when reading shared rows */
+    double **rows;          /* row pointers for the unrolled kernels */
+    const double *x;        /* contiguous rows for the blocked path */
+    double *local_weights;  /* private copy of the row weights */
+    const double *weights;  /* weights of this worker's rows, NULL if unweighted */
+    double *err;
+    double *grad;
+    int failed;
+    int pin_failed;
+    pthread_t thread;
+} GDWorker;
+
+struct GDContext {
+    LinearRegression *lr;
+    const CSVData *data;
+    double alpha;
+    double total_weight;    /* sum of sample weights (row count when unweighted) */
+    unsigned int iterations;
+    const GDOptions *opts;
+    const Topology *topo;
+    const LRKernels *kernels;
+    int blocked;            /* blocked GEMV kernel instead of the row kernels */
+    int backend_threads;    /* linalg threads per call during this run */
+    size_t block;
+    size_t batch;           /* rows per step, 0 for full batch */
+    double *weight_prefix;  /* prefix sums of the weights, for mini-batch means */
+    GDWorker *workers;
+    size_t n_workers;
+    pthread_barrier_t barrier;
+    pthread_mutex_t gate_lock;  /* workers wait here until all have been created */
+    pthread_cond_t gate_cond;
+    int gate_open;
+    int abort;
+    unsigned int checkpoints;
+};
+
+/* Allocate and fill the worker's buffers. Called from the (pinned) worker
+ * thread, so first-touch places every page on the worker's node. */
+static int worker_prepare(GDWorker *w) {
+    GDContext *ctx = w->ctx;
+    const CSVData *data = ctx->data;
+    size_t cols = data->cols;
+    size_t m = w->row_end - w->row_begin;
+
+    w->grad = calloc(ctx->lr->n_features, sizeof(double));
+    if (!w->grad) return -1;
+
+    /* The blocked path needs contiguous rows; hand-built CSVData without
+       `values` is packed here as well. */
+    int copy = ctx->opts->placement == GD_PLACE_FIRST_TOUCH ||
+               (ctx->blocked && !data->values);
+    if (copy) {
+        w->local = malloc(m * cols * sizeof(double));
+        if (!w->local) return -1;
+        for (size_t i = 0; i < m; ++i) {
+            memcpy(w->local + i * cols, data->data[w->row_begin + i], cols * sizeof(double));
+        }
+    }
+
+    if (data->weights) {
+        if (ctx->opts->placement == GD_PLACE_FIRST_TOUCH) {
+            w->local_weights = malloc(m * sizeof(double));
+            if (!w->local_weights) return -1;
+            memcpy(w->local_weights, data->weights + w->row_begin, m * sizeof(double));
+            w->weights = w->local_weights;
+        } else {
+            w->weights = data->weights + w->row_begin;
+        }
+    }
+
+    if (!ctx->blocked) {
+        if (w->local) {
+            w->rows = malloc(m * sizeof(double*));
+            if (!w->rows) return -1;
+            for (size_t i = 0; i < m; ++i) w->rows[i] = w->local + i * cols;
+        }
+    } else {
+        w->x = w->local ? w->local : data->values + w->row_begin * cols;
+        w->err = malloc(ctx->block * sizeof(double));
+        if (!w->err) return -1;
+    }
+    return 0;
+}
+
+/* First row of the mini-batch window of iteration `iter` of this call. */
+static size_t batch_start(const GDContext *ctx, unsigned int iter) {
+    uint64_t step = (uint64_t)ctx->opts->start_iteration + iter;
+    return (size_t)((step * ctx->batch) % ctx->data->rows);
+}
+
+/* Add the gradient over global rows [lo, hi), clipped to this worker's block. */
+static void worker_gradient_range(GDWorker *w, size_t lo, size_t hi) {
+    GDContext *ctx = w->ctx;
+    const double *theta = ctx->lr->theta;
+    size_t cols = ctx->data->cols;
+
+    if (lo < w->row_begin) lo = w->row_begin;
+    if (hi > w->row_end) hi = w->row_end;
+    if (lo >= hi) return;
+
+    size_t off = lo - w->row_begin;
+    const double *weights = w->weights ? w->weights + off : NULL;
+
+    if (!ctx->blocked) {
+        double *const *rows = w->rows ? w->rows + off : ctx->data->data + lo;
+        ctx->kernels->gradient(theta, rows, weights, hi - lo, cols - 1, w->grad);
+    } else {
+        gradient_blocked(theta, w->x + off * cols, cols, weights, hi - lo, cols - 1,
+                         ctx->block, w->err, w->grad);
+    }
+}
+
+static void worker_partial_gradient(GDWorker *w, unsigned int iter) {
+    GDContext *ctx = w->ctx;
+    size_t m = ctx->data->rows;
+
+    for (size_t j = 0; j < ctx->data->cols; ++j) {
+        w->grad[j] = 0.0;
+    }
+
+    if (!ctx->batch) {
+        worker_gradient_range(w, w->row_begin, w->row_end);
+        return;
+    }
+
+    /* The window may wrap past the last row. */
+    size_t start = batch_start(ctx, iter);
+    size_t end = start + ctx->batch;
+    worker_gradient_range(w, start, end < m ? end : m);
+    if (end > m) worker_gradient_range(w, 0, end - m);
+}
+
+/* Total weight of the rows the gradient of iteration `iter` was taken over. */
+static double step_weight(const GDContext *ctx, unsigned int iter) {
+    if (!ctx->batch) return ctx->total_weight;
+    if (!ctx->weight_prefix) return (double)ctx->batch;
+
+    size_t m = ctx->data->rows;
+    size_t start = batch_start(ctx, iter);
+    size_t end = start + ctx->batch;
+    const double *p = ctx->weight_prefix;
+    if (end <= m) return p[end] - p[start];
+    return (p[m] - p[start]) + p[end - m];
+}
+
+/* Sum the partial gradients in worker order and take one step. */
+static void reduce_and_update(GDContext *ctx, unsigned int iter) {
+    LinearRegression *lr = ctx->lr;
+    double weight = step_weight(ctx, iter);
+    if (weight <= 0.0) return;     /* window of zero-weight rows: no step */
+    double scale = ctx->alpha / weight;
+
+    for (size_t j = 0; j < lr->n_features; ++j) {
+        double g = ctx->workers[0].grad[j];
+        for (size_t t = 1; t < ctx->n_workers; ++t) {
+            g += ctx->workers[t].grad[j];
+        }
+        lr->theta[j] -= scale * g;
+    }
+}
+
+/* Snapshot theta after iteration `iter` of this call if an interval ends here.
+ * Only copies the parameters; the writer thread does the I/O. */
+static void maybe_checkpoint(GDContext *ctx, unsigned int iter) {
+    const GDOptions *opts = ctx->opts;
+    if (!opts->checkpoint || opts->checkpoint_interval == 0) return;
+
+    uint64_t done = (uint64_t)opts->start_iteration + iter + 1;
+    if (done % opts->checkpoint_interval != 0 || iter + 1 == ctx->iterations) return;
+
+    checkpoint_submit(opts->checkpoint, done, ctx->alpha, ctx->batch, ctx->lr->theta);
+    ctx->checkpoints++;
+}
+
+static void *worker_main(void *arg) {
+    GDWorker *w = arg;
+    GDContext *ctx = w->ctx;
+    const TopologyNode *node = &ctx->topo->nodes[w->node];
+
+    if (ctx->opts->pin == GD_PIN_CORE) {
+        w->pin_failed = topology_pin_thread(&w->cpu, 1) != 0;
+    } else if (ctx->opts->pin == GD_PIN_NODE) {
+        w->pin_failed = topology_pin_thread(node->cpus, node->n_cpus) != 0;
+    }
+
+    pthread_mutex_lock(&ctx->gate_lock);
+    while (!ctx->gate_open) pthread_cond_wait(&ctx->gate_cond, &ctx->gate_lock);
+    int abort = ctx->abort;
+    pthread_mutex_unlock(&ctx->gate_lock);
+    if (abort) return NULL;
+
+    w->failed = worker_prepare(w) != 0;
+
+    pthread_barrier_wait(&ctx->barrier);
+    if (w->index == 0) {
+        for (size_t t = 0; t < ctx->n_workers; ++t) {
+            if (ctx->workers[t].failed) ctx->abort = 1;
+        }
+    }
+    pthread_barrier_wait(&ctx->barrier);
+    if (ctx->abort) return NULL;
+
+    for (unsigned int iter = 0; iter < ctx->iterations; ++iter) {
+        worker_partial_gradient(w, iter);
+        pthread_barrier_wait(&ctx->barrier);
+        if (w->index == 0) {
+            reduce_and_update(ctx, iter);
+            maybe_checkpoint(ctx, iter);
+        }
+        pthread_barrier_wait(&ctx->barrier);
+    }
+    return NULL;
+}
+
+/* Assign workers to nodes (consecutive workers share a node), CPUs within
+ * their node, and contiguous row blocks. */
+static void assign_workers(GDContext *ctx) {
+    size_t n_nodes = ctx->topo->n_nodes;
+    size_t n = ctx->n_workers;
+    size_t m = ctx->data->rows;
+
+    for (size_t t = 0; t < n; ++t) {
+        GDWorker *w = &ctx->workers[t];
+        w->ctx = ctx;
+        w->index = t;
+        w->node = t * n_nodes / n;
+
+        /* first worker on this node, so each node hands out its CPUs from the start */
+        size_t first = (w->node * n + n_nodes - 1) / n_nodes;
+        const TopologyNode *node = &ctx->topo->nodes[w->node];
+        w->cpu = node->cpus[(t - first) % node->n_cpus];
+        w->row_begin = m * t / n;
+        w->row_end = m * (t + 1) / n;
+    }
+}
+
+static void fill_stats(const GDContext *ctx, GDStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->threads = (unsigned int)ctx->n_workers;
+    stats->nodes_detected = ctx->topo->n_nodes;
+    stats->pin = ctx->opts->pin;
+    stats->placement = ctx->opts->placement;
+    if (ctx->blocked) stats->kernel = "blocked-gemv";
+    else stats->kernel = ctx->kernels->unrolled ? "unrolled" : "generic";
+    stats->backend = linalg_backend_name();
+    stats->backend_threads = ctx->backend_threads;
+    stats->block_rows = ctx->blocked ? ctx->block : 0;
+    stats->batch_size = ctx->batch ? ctx->batch : ctx->data->rows;
+    stats->checkpoints = ctx->checkpoints;
+
+    for (size_t t = 0; t < ctx->n_workers; ++t) {
+        const GDWorker *w = &ctx->workers[t];
+        int id = ctx->topo->nodes[w->node].id;
+        size_t k = stats->n_nodes;
+
+        if (k == 0 || stats->nodes[k - 1].id != id) {
+            if (k == GD_STATS_MAX_NODES) continue;
+            stats->nodes[k].id = id;
+            stats->n_nodes = ++k;
+        }
+        stats->nodes[k - 1].threads++;
+        stats->nodes[k - 1].rows += w->row_end - w->row_begin;
+        if (w->pin_failed) stats->pin_failures++;
+    }
+}
+
+static void free_workers(GDContext *ctx) {
+    for (size_t t = 0; t < ctx->n_workers; ++t) {
+        GDWorker *w = &ctx->workers[t];
+        free(w->local);
+        free(w->local_weights);
+        free(w->rows);
+        free(w->err);
+        free(w->grad);
+    }
+    free(ctx->workers);
+    free(ctx->weight_prefix);
+}
+
+/* ---------- Public API ---------- */
+
+/* Execution plan shared by gradient_descent_ex() and gd_working_set(), so the
+ * estimate follows what training allocates. */
+static int use_blocked(const GDOptions *opts, size_t n_features) {
+    if (opts->kernel == GD_KERNEL_AUTO) return !kernels_select(n_features)->unrolled;
+    return opts->kernel == GD_KERNEL_BLOCKED;
+}
+
+static size_t worker_count(const GDOptions *opts, size_t cpus, size_t m) {
+    size_t threads = opts->threads ? opts->threads : cpus;
+    if (threads == 0) threads = 1;
+    return threads < m ? threads : m;
+}
+
+/* Rows per block of the blocked path, at most one worker's share. */
+static size_t block_rows(const GDOptions *opts, size_t cols, size_t per_worker) {
+    size_t block_bytes = opts->block_bytes ? opts->block_bytes : GD_DEFAULT_BLOCK_BYTES;
+    size_t block = block_bytes / (cols * sizeof(double));
+    if (block == 0) block = 1;
+    return block < per_worker ? block : per_worker;
+}
+
+void gd_default_options(GDOptions *opts) {
+    if (!opts) return;
+    opts->threads = 1;
+    opts->pin = GD_PIN_NONE;
+    opts->placement = GD_PLACE_SHARED;
+    opts->kernel = GD_KERNEL_AUTO;
+    opts->block_bytes = 0;
+    opts->batch_size = 0;
+    opts->checkpoint = NULL;
+    opts->checkpoint_interval = 0;
+    opts->start_iteration = 0;
+}
 
 int gradient_descent(
     LinearRegression *lr,
     const CSVData *data,
     double alpha,
     unsigned int iterations
+) {
+    return gradient_descent_ex(lr, data, alpha, iterations, NULL, NULL);
+}
+
+int gradient_descent_ex(
+    LinearRegression *lr,
+    const CSVData *data,
+    double alpha,
+    unsigned int iterations,
+    const GDOptions *opts,
+    GDStats *stats
 ) {
     if (!lr || !data || data->rows == 0 || data->cols < 2 || alpha <= 0.0 || iterations == 0) {
         fprintf(stderr, "gradient_descent: invalid parameters\n");
@@ -20,42 +399,215 @@ int gradient_descent(
        LinearRegression stores n_features = features + bias term
     */
 
-    size_t m = data->rows;                
-    size_t n_features = data->cols - 1;   
+    size_t m = data->rows;
+    size_t n_features = data->cols - 1;
     if ((size_t)lr->n_features != (n_features + 1)) { /* +1 for bias term */
         fprintf(stderr, "gradient_descent: model feature count mismatch\n");
         return -1;
     }
 
-    double *gradients = calloc(lr->n_features, sizeof(double));
-    if (!gradients) {
+    /* Weighted samples scale the error and the mean; a row with weight k is
+       equivalent to k copies of it. */
+    double total_weight = (double)m;
+    if (data->weights) {
+        total_weight = 0.0;
+        for (size_t i = 0; i < m; ++i) {
+            if (!(data->weights[i] >= 0.0)) {
+                fprintf(stderr, "gradient_descent: invalid sample weight\n");
+                return -1;
+            }
+            total_weight += data->weights[i];
+        }
+        if (total_weight <= 0.0) {
+            fprintf(stderr, "gradient_descent: sample weights sum to zero\n");
+            return -1;
+        }
+    }
+
+    GDOptions defaults;
+    if (!opts) {
+        gd_default_options(&defaults);
+        opts = &defaults;
+    }
+
+    Topology topo;
+    if (topology_detect(&topo) != 0) {
         fprintf(stderr, "gradient_descent: memory allocation failed\n");
         return -1;
     }
 
-    for (unsigned int iter = 0; iter < iterations; ++iter) {
-        for (size_t j = 0; j < lr->n_features; ++j) {
-            gradients[j] = 0.0;
-        }
+    GDContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.lr = lr;
+    ctx.data = data;
+    ctx.alpha = alpha;
+    ctx.total_weight = total_weight;
+    ctx.iterations = iterations;
+    ctx.opts = opts;
+    ctx.topo = &topo;
 
+    /* Small feature counts use the fused unrolled kernels; everything else
+       goes through the blocked GEMV formulation. */
+    ctx.kernels = kernels_select(n_features);
+    ctx.blocked = use_blocked(opts, n_features);
+
+    ctx.batch = (opts->batch_size < m) ? opts->batch_size : 0;
+    if (ctx.batch && data->weights) {
+        ctx.weight_prefix = malloc((m + 1) * sizeof(double));
+        if (!ctx.weight_prefix) {
+            fprintf(stderr, "gradient_descent: memory allocation failed\n");
+            topology_free(&topo);
+            return -1;
+        }
+        ctx.weight_prefix[0] = 0.0;
         for (size_t i = 0; i < m; ++i) {
-            double prediction = lr->theta[0];
-            for (size_t j = 0; j < n_features; ++j) {
-                prediction += lr->theta[j + 1] * data->data[i][j];
-            }
-            double error = prediction - data->data[i][n_features]; 
-            
-            gradients[0] += error; 
-            for (size_t j = 0; j < n_features; ++j) {
-                gradients[j + 1] += error * data->data[i][j];
+            ctx.weight_prefix[i + 1] = ctx.weight_prefix[i] + data->weights[i];
+        }
+    }
+
+    size_t threads = worker_count(opts, topology_cpu_count(&topo), m);
+    ctx.n_workers = threads;
+    ctx.block = block_rows(opts, data->cols, (m + threads - 1) / threads);
+
+    ctx.workers = calloc(threads, sizeof(GDWorker));
+    if (!ctx.workers) {
+        fprintf(stderr, "gradient_descent: memory allocation failed\n");
+        free(ctx.weight_prefix);
+        topology_free(&topo);
+        return -1;
+    }
+    assign_workers(&ctx);
+
+    if (pthread_barrier_init(&ctx.barrier, NULL, (unsigned int)threads) != 0) {
+        fprintf(stderr, "gradient_descent: failed to initialize barrier\n");
+        free(ctx.workers);
+        free(ctx.weight_prefix);
+        topology_free(&topo);
+        return -1;
+    }
+    pthread_mutex_init(&ctx.gate_lock, NULL);
+    pthread_cond_init(&ctx.gate_cond, NULL);
+
+    /* Each worker already owns a CPU and its own row block; a threaded BLAS
+       under every worker would oversubscribe the cores and read the blocks
+       from unpinned threads. Restored when training ends. */
+    int saved_backend_threads = linalg_get_threads();
+    if (threads > 1 && saved_backend_threads > 1) linalg_set_threads(1);
+    ctx.backend_threads = linalg_get_threads();
+
+    int result = 0;
+
+    if (threads == 1 && opts->pin == GD_PIN_NONE) {
+        /* A single unpinned worker runs on the calling thread. */
+        ctx.gate_open = 1;
+        worker_main(&ctx.workers[0]);
+    } else {
+        size_t started = 0;
+        for (; started < threads; ++started) {
+            if (pthread_create(&ctx.workers[started].thread, NULL, worker_main,
+                               &ctx.workers[started]) != 0) {
+                break;
             }
         }
 
-        for (size_t j = 0; j < lr->n_features; ++j) {
-            lr->theta[j] -= (alpha / (double)m) * gradients[j];
+        /* Workers only reach the barrier once the gate opens, so a partial
+           start can still be unwound. */
+        pthread_mutex_lock(&ctx.gate_lock);
+        if (started < threads) {
+            fprintf(stderr, "gradient_descent: failed to start worker threads\n");
+            ctx.abort = 1;
+            result = -1;
+        }
+        ctx.gate_open = 1;
+        pthread_cond_broadcast(&ctx.gate_cond);
+        pthread_mutex_unlock(&ctx.gate_lock);
+
+        for (size_t t = 0; t < started; ++t) {
+            pthread_join(ctx.workers[t].thread, NULL);
         }
     }
 
-    free(gradients);
-    return 0;
+    if (ctx.abort && result == 0) {
+        fprintf(stderr, "gradient_descent: memory allocation failed\n");
+        result = -1;
+    }
+
+    if (result == 0 && opts->checkpoint) {
+        checkpoint_submit(opts->checkpoint, (uint64_t)opts->start_iteration + iterations,
+                          alpha, ctx.batch, lr->theta);
+        ctx.checkpoints++;
+    }
+
+    if (stats) fill_stats(&ctx, stats);
+    if (ctx.backend_threads != saved_backend_threads) linalg_set_threads(saved_backend_threads);
+
+    pthread_cond_destroy(&ctx.gate_cond);
+    pthread_mutex_destroy(&ctx.gate_lock);
+    pthread_barrier_destroy(&ctx.barrier);
+    free_workers(&ctx);
+    topology_free(&topo);
+    return result;
+}
+
+size_t gd_working_set(const CSVData *data, const GDOptions *opts) {
+    GDOptions defaults;
+    if (!opts) {
+        gd_default_options(&defaults);
+        opts = &defaults;
+    }
+    if (!data || data->rows == 0 || data->cols < 2) return 0;
+
+    size_t m = data->rows;
+    size_t cols = data->cols;
+    size_t cpus = 0;
+    if (opts->threads == 0) {
+        Topology topo;
+        if (topology_detect(&topo) == 0) {
+            cpus = topology_cpu_count(&topo);
+            topology_free(&topo);
+        }
+    }
+    size_t threads = worker_count(opts, cpus, m);
+    int blocked = use_blocked(opts, cols - 1);
+    int first_touch = opts->placement == GD_PLACE_FIRST_TOUCH;
+
+    size_t bytes = threads * (sizeof(GDWorker) + cols * sizeof(double));    /* grad */
+    if (blocked) {
+        bytes += threads * block_rows(opts, cols, (m + threads - 1) / threads) * sizeof(double);
+    }
+    if (first_touch || (blocked && !data->values)) {
+        bytes += m * cols * sizeof(double);                                 /* row copies */
+        if (!blocked) bytes += m * sizeof(double*);
+    }
+    if (data->weights && first_touch) bytes += m * sizeof(double);
+    if (data->weights && opts->batch_size && opts->batch_size < m) {
+        bytes += (m + 1) * sizeof(double);                                  /* weight prefix */
+    }
+    return bytes;
+}
+
+void gd_print_stats(const GDStats *stats) {
+    static const char *pin_names[] = { "none", "core", "node" };
+    static const char *placement_names[] = { "shared", "first-touch" };
+
+    if (!stats) return;
+    printf("Training stats:\n");
+    printf("  topology: %zu NUMA node(s) detected, %zu used\n",
+           stats->nodes_detected, stats->n_nodes);
+    for (size_t k = 0; k < stats->n_nodes; ++k) {
+        printf("    node %d: %u thread(s), %zu rows\n",
+               stats->nodes[k].id, stats->nodes[k].threads, stats->nodes[k].rows);
+    }
+    printf("  threads: %u, pin: %s, placement: %s",
+           stats->threads, pin_names[stats->pin], placement_names[stats->placement]);
+    if (stats->pin_failures) printf(" (%u pin request(s) refused)", stats->pin_failures);
+    printf("\n");
+    if (stats->block_rows) {
+        printf("  kernel: %s (%s, %d thread(s)/call, %zu rows/block)\n",
+               stats->kernel, stats->backend, stats->backend_threads, stats->block_rows);
+    } else {
+        printf("  kernel: %s\n", stats->kernel);
+    }
+    printf("  batch: %zu rows/step\n", stats->batch_size);
+    if (stats->checkpoints) printf("  checkpoints: %u\n", stats->checkpoints);
 }
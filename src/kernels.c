@@ -0,0 +1,131 @@
+#include "../include/kernels.h"
+
+/* ---------- Generic kernels ---------- */
+
+static double predict_generic(const double *theta, const double *x, size_t n_inputs) {
+    double result = theta[0];
+    for (size_t j = 0; j < n_inputs; ++j) {
+        result += theta[j + 1] * x[j];
+    }
+    return result;
+}
+
+static void gradient_generic(const double *theta, double *const *rows, const double *w,
+                             size_t m, size_t n_inputs, double *grad) {
+    for (size_t i = 0; i < m; ++i) {
+        const double *x = rows[i];
+        double prediction = theta[0];
+        for (size_t j = 0; j < n_inputs; ++j) {
+            prediction += theta[j + 1] * x[j];
+        }
+        double error = prediction - x[n_inputs];
+        if (w) error *= w[i];
+
+        grad[0] += error;
+        for (size_t j = 0; j < n_inputs; ++j) {
+            grad[j + 1] += error * x[j];
+        }
+    }
+}
+
+/* ---------- Unrolled kernels ---------- */
+
+/* REP_N(M) expands to M(0) M(1) ... M(N-1). */
+#define REP_1(M)  M(0)
+#define REP_2(M)  REP_1(M) M(1)
+#define REP_3(M)  REP_2(M) M(2)
+#define REP_4(M)  REP_3(M) M(3)
+#define REP_5(M)  REP_4(M) M(4)
+#define REP_6(M)  REP_5(M) M(5)
+#define REP_7(M)  REP_6(M) M(6)
+#define REP_8(M)  REP_7(M) M(7)
+#define REP_9(M)  REP_8(M) M(8)
+#define REP_10(M) REP_9(M) M(9)
+#define REP_11(M) REP_10(M) M(10)
+#define REP_12(M) REP_11(M) M(11)
+#define REP_13(M) REP_12(M) M(12)
+#define REP_14(M) REP_13(M) M(13)
+#define REP_15(M) REP_14(M) M(14)
+#define REP_16(M) REP_15(M) M(15)
+
+#define LOAD_THETA(j) const double t##j = theta[(j) + 1];
+#define DOT_TERM(j)   + t##j * x[j]
+#define LOAD_GRAD(j)  double g##j = grad[(j) + 1];
+#define ACC_GRAD(j)   g##j += error * x[j];
+#define STORE_GRAD(j) grad[(j) + 1] = g##j;
+
+/* Row loop of the unrolled gradient kernel; WEIGHT(i) scales the error of row i. */
+#define GRADIENT_LOOP(N, WEIGHT)                                                     \
+    for (size_t i = 0; i < m; ++i) {                                                 \
+        const double *x = rows[i];                                                   \
+        const double error = ((t_bias REP_##N(DOT_TERM)) - x[N]) WEIGHT(i);          \
+        g_bias += error;                                                             \
+        REP_##N(ACC_GRAD)                                                            \
+    }
+#define UNWEIGHTED(i)
+#define WEIGHTED(i) * w[i]
+
+/* The prediction is written as one left-associative sum starting from the bias,
+ * which matches the evaluation order of the generic loop. */
+#define DEFINE_KERNELS(N)                                                            \
+    static double predict_##N(const double *theta, const double *x, size_t n_inputs) { \
+        (void)n_inputs;                                                              \
+        const double t_bias = theta[0];                                              \
+        REP_##N(LOAD_THETA)                                                          \
+        return t_bias REP_##N(DOT_TERM);                                             \
+    }                                                                                \
+    static void gradient_##N(const double *theta, double *const *rows,              \
+                             const double *w, size_t m, size_t n_inputs,             \
+                             double *grad) {                                         \
+        (void)n_inputs;                                                              \
+        const double t_bias = theta[0];                                              \
+        REP_##N(LOAD_THETA)                                                          \
+        double g_bias = grad[0];                                                     \
+        REP_##N(LOAD_GRAD)                                                           \
+        if (w) {                                                                     \
+            GRADIENT_LOOP(N, WEIGHTED)                                               \
+        } else {                                                                     \
+            GRADIENT_LOOP(N, UNWEIGHTED)                                             \
+        }                                                                            \
+        grad[0] = g_bias;                                                            \
+        REP_##N(STORE_GRAD)                                                          \
+    }
+
+DEFINE_KERNELS(1)
+DEFINE_KERNELS(2)
+DEFINE_KERNELS(3)
+DEFINE_KERNELS(4)
+DEFINE_KERNELS(5)
+DEFINE_KERNELS(6)
+DEFINE_KERNELS(7)
+DEFINE_KERNELS(8)
+DEFINE_KERNELS(9)
+DEFINE_KERNELS(10)
+DEFINE_KERNELS(11)
+DEFINE_KERNELS(12)
+DEFINE_KERNELS(13)
+DEFINE_KERNELS(14)
+DEFINE_KERNELS(15)
+DEFINE_KERNELS(16)
+
+/* ---------- Dispatch ---------- */
+
+#define KERNEL_ENTRY(N) { predict_##N, gradient_##N, N }
+
+/* Indexed by input count; entry 0 is the generic fallback. */
+static const LRKernels kernel_table[KERNELS_MAX_UNROLLED + 1] = {
+    { predict_generic, gradient_generic, 0 },
+    KERNEL_ENTRY(1),  KERNEL_ENTRY(2),  KERNEL_ENTRY(3),  KERNEL_ENTRY(4),
+    KERNEL_ENTRY(5),  KERNEL_ENTRY(6),  KERNEL_ENTRY(7),  KERNEL_ENTRY(8),
+    KERNEL_ENTRY(9),  KERNEL_ENTRY(10), KERNEL_ENTRY(11), KERNEL_ENTRY(12),
+    KERNEL_ENTRY(13), KERNEL_ENTRY(14), KERNEL_ENTRY(15), KERNEL_ENTRY(16),
+};
+
+const LRKernels* kernels_select(size_t n_inputs) {
+    if (n_inputs > KERNELS_MAX_UNROLLED) return &kernel_table[0];
+    return &kernel_table[n_inputs];
+}
+
+const LRKernels* kernels_generic(void) {
+    return &kernel_table[0];
+}
@@ -0,0 +1,80 @@
+#include "../include/linalg.h"
+
+#ifdef LR_HAVE_CBLAS
+#include <cblas.h>
+#endif
+
+#ifdef LR_HAVE_CBLAS
+
+void linalg_gemv(size_t m, size_t n, double alpha, const double *a, size_t lda,
+                 const double *x, double beta, double *y) {
+    if (m == 0) return;
+    cblas_dgemv(CblasRowMajor, CblasNoTrans, (int)m, (int)n, alpha, a, (int)lda,
+                x, 1, beta, y, 1);
+}
+
+void linalg_gemv_t(size_t m, size_t n, double alpha, const double *a, size_t lda,
+                   const double *x, double beta, double *y) {
+    if (n == 0) return;
+    cblas_dgemv(CblasRowMajor, CblasTrans, (int)m, (int)n, alpha, a, (int)lda,
+                x, 1, beta, y, 1);
+}
+
+/* LR_HAVE_CBLAS is only defined for OpenBLAS (see Makefile), whose cblas.h
+ * declares these. */
+int linalg_get_threads(void) {
+    return openblas_get_num_threads();
+}
+
+void linalg_set_threads(int n) {
+    openblas_set_num_threads(n > 0 ? n : 1);
+}
+
+const char* linalg_backend_name(void) {
+    return "cblas";
+}
+
+#else /* portable fallback */
+
+void linalg_gemv(size_t m, size_t n, double alpha, const double *a, size_t lda,
+                 const double *x, double beta, double *y) {
+    for (size_t i = 0; i < m; ++i) {
+        const double *row = a + i * lda;
+        double dot = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            dot += row[j] * x[j];
+        }
+        y[i] = alpha * dot + (beta == 0.0 ? 0.0 : beta * y[i]);
+    }
+}
+
+/* Sweeps A row by row (axpy form) so the row-major layout is read sequentially. */
+void linalg_gemv_t(size_t m, size_t n, double alpha, const double *a, size_t lda,
+                   const double *x, double beta, double *y) {
+    if (beta == 0.0) {
+        for (size_t j = 0; j < n; ++j) y[j] = 0.0;
+    } else if (beta != 1.0) {
+        for (size_t j = 0; j < n; ++j) y[j] *= beta;
+    }
+    for (size_t i = 0; i < m; ++i) {
+        const double *row = a + i * lda;
+        const double s = alpha * x[i];
+        for (size_t j = 0; j < n; ++j) {
+            y[j] += s * row[j];
+        }
+    }
+}
+
+int linalg_get_threads(void) {
+    return 1;
+}
+
+void linalg_set_threads(int n) {
+    (void)n;
+}
+
+const char* linalg_backend_name(void) {
+    return "portable";
+}
+
+#endif /* LR_HAVE_CBLAS */
@@ -1,4 +1,5 @@
 #include "../include/linear_regression.h"
+#include "../include/kernels.h"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -31,13 +32,8 @@ double lr_predict(const LinearRegression *lr, const double *features) {
         return 0.0;
     }
 
-    double result = lr->theta[0];
-
-    for (size_t j = 0; j < lr->n_features - 1; ++j) {
-        result += lr->theta[j + 1] * features[j];
-    }
-
-    return result;
+    size_t n_inputs = lr->n_features - 1;
+    return kernels_select(n_inputs)->predict(lr->theta, features, n_inputs);
 }
 
 void lr_free(LinearRegression *lr) {
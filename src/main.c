@@ -3,21 +3,27 @@
 #include "csv_reader.h"
 #include "linear_regression.h"
 #include "gradient_descent.h"
+#include "checkpoint.h"
+#include "config.h"
 #include "utils.h"
 
-#define LEARNING_RATE 0.01
-#define ITERATIONS 1000
-
-int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <csv_file>\n", argv[0]);
-        return EXIT_FAILURE;
-    }
-
-    const char *csv_file = argv[1];
+/* Load, train and report as configured by `cfg`. Returns the exit status. */
+static int run(LRConfig *cfg) {
+    GDOptions opts;
+    config_gd_options(cfg, &opts);
+    const char *csv_file = cfg->data_path;
+    const char *checkpoint_path = cfg->checkpoint_path;
+
+    /* Columns may be given by header name or 0-based index */
+    CSVSchema schema = {
+        .features = (const char *const *)cfg->features,
+        .n_features = cfg->n_features,
+        .target = cfg->target,
+        .max_bytes = cfg->memory_budget
+    };
 
     /* 1. Load CSV data */
-    CSVData *data = csv_read(csv_file);
+    CSVData *data = csv_read_schema(csv_file, &schema);
     if (!data) {
         fprintf(stderr, "Error: Failed to read CSV file '%s'\n", csv_file);
         return EXIT_FAILURE;
@@ -29,6 +35,41 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
 
+    if (cfg->dedup) {
+        size_t before = data->rows;
+        long removed = csv_compact_duplicates(data);
+        if (removed < 0) {
+            fprintf(stderr, "Error: Failed to compact duplicate rows\n");
+            csv_free(data);
+            return EXIT_FAILURE;
+        }
+        printf("Compacted %zu rows into %zu weighted samples\n", before, data->rows);
+    }
+
+    /* A profile tuned on data of another width falls back to auto */
+    if (config_match_profile(cfg, data)) {
+        opts.kernel = cfg->kernel;
+        opts.block_bytes = cfg->block_bytes;
+    }
+
+    /* Tune on the loaded data before training with the winner */
+    if (cfg->autotune) {
+        if (config_autotune(cfg, data) != 0) {
+            fprintf(stderr, "Error: Autotune failed\n");
+            csv_free(data);
+            return EXIT_FAILURE;
+        }
+        opts.kernel = cfg->kernel;
+        opts.threads = cfg->threads;
+        opts.block_bytes = cfg->block_bytes;
+    }
+
+    /* Check against the kernel, threads and block size training will use */
+    if (config_check_memory(cfg, data, &opts) != 0) {
+        csv_free(data);
+        return EXIT_FAILURE;
+    }
+
     size_t n_features = data->cols; /* includes bias term in model */
 
     /* 2. Create Linear Regression model */
@@ -39,18 +80,79 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
 
-    /* 3. Train model with Gradient Descent */
-    if (gradient_descent(lr, data, LEARNING_RATE, ITERATIONS) != 0) {
+    /* 3. Resume from the latest valid checkpoint, if any */
+    double alpha = cfg->learning_rate;
+    unsigned int done = 0;
+    Checkpointer *cp = NULL;
+
+    if (checkpoint_path) {
+        uint64_t fingerprint = csv_fingerprint(data);
+        uint64_t resumed = 0, resumed_batch = 0;
+        if (checkpoint_load_latest(checkpoint_path, fingerprint, n_features,
+                                   lr->theta, &resumed, &alpha, &resumed_batch)) {
+            /* A resume must continue the same step schedule; training treats
+               a batch at least as large as the data as full batch (0). */
+            uint64_t batch = opts.batch_size < data->rows ? opts.batch_size : 0;
+            if (alpha != cfg->learning_rate || resumed_batch != batch) {
+                fprintf(stderr, "Error: Checkpoint '%s' was written with learning rate %g and "
+                                "batch size %llu, this run uses %g and %llu (0 = full batch); "
+                                "use the same settings or another checkpoint path\n",
+                        checkpoint_path, alpha, (unsigned long long)resumed_batch,
+                        cfg->learning_rate, (unsigned long long)batch);
+                lr_free(lr);
+                csv_free(data);
+                return EXIT_FAILURE;
+            }
+            /* theta is from that iteration; it cannot be rolled back */
+            if (resumed > cfg->iterations) {
+                fprintf(stderr, "Error: Checkpoint '%s' is at iteration %llu, past the %u "
+                                "iterations requested; raise --iterations or use another "
+                                "checkpoint path\n",
+                        checkpoint_path, (unsigned long long)resumed, cfg->iterations);
+                lr_free(lr);
+                csv_free(data);
+                return EXIT_FAILURE;
+            }
+            done = (unsigned int)resumed;
+            printf("Resumed from checkpoint '%s' at iteration %u\n", checkpoint_path, done);
+        }
+
+        cp = checkpoint_open(checkpoint_path, fingerprint, n_features);
+        if (!cp) {
+            fprintf(stderr, "Error: Failed to open checkpoint '%s'\n", checkpoint_path);
+            lr_free(lr);
+            csv_free(data);
+            return EXIT_FAILURE;
+        }
+        opts.checkpoint = cp;
+        opts.start_iteration = done;
+    }
+
+    /* 4. Train model with Gradient Descent */
+    GDStats stats;
+    int trained = done < cfg->iterations;
+    if (trained && gradient_descent_ex(lr, data, alpha, cfg->iterations - done, &opts, &stats) != 0) {
         fprintf(stderr, "Error: Gradient descent failed\n");
+        checkpoint_close(cp);
         lr_free(lr);
         csv_free(data);
         return EXIT_FAILURE;
     }
+    if (cp && checkpoint_close(cp) != 0) {
+        fprintf(stderr, "Warning: Some checkpoints could not be written\n");
+    }
 
-    /* 4. Print final parameters */
+    /* 5. Print final parameters */
+    if (data->col_names) {
+        printf("Trained on: [bias");
+        for (size_t j = 0; j + 1 < data->cols; j++) {
+            printf(", %s", data->col_names[j]);
+        }
+        printf("] -> %s\n", data->col_names[data->cols - 1]);
+    }
     utils_print_vector("Final parameters: ", lr->theta, n_features);
 
-    /* 5. Compute and print training error */
+    /* 6. Compute and print training error */
     double *predictions = malloc(data->rows * sizeof(double));
     if (!predictions) {
         fprintf(stderr, "Error: Memory allocation failed for predictions\n");
@@ -76,10 +178,11 @@ int main(int argc, char *argv[]) {
         targets[i] = data->data[i][data->cols - 1]; /* last column = target */
     }
 
-    double mse = utils_mse(predictions, targets, data->rows);
+    double mse = utils_weighted_mse(predictions, targets, data->weights, data->rows);
     printf("Training MSE: %.6f\n", mse);
+    if (trained) gd_print_stats(&stats);
 
-    /* 6. Cleanup */
+    /* 7. Cleanup */
     free(predictions);
     free(targets);
     lr_free(lr);
@@ -87,3 +190,17 @@ int main(int argc, char *argv[]) {
 
     return EXIT_SUCCESS;
 }
+
+int main(int argc, char *argv[]) {
+    LRConfig cfg;
+    int loaded = config_load(&cfg, argc, argv);
+    if (loaded != 0 || !cfg.data_path) {
+        if (loaded >= 0) config_usage(argv[0]);
+        config_free(&cfg);
+        return loaded == 1 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    int status = run(&cfg);
+    config_free(&cfg);
+    return status;
+}
@@ -0,0 +1,192 @@
+#define _GNU_SOURCE
+
+#include "../include/topology.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+/* ---------- Helpers (static) ---------- */
+
+/* Read the first line of a small sysfs file into `buf`. Returns 0 on success. */
+static int read_sysfs_line(const char *path, char *buf, size_t size) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char *r = fgets(buf, (int)size, f);
+    fclose(f);
+    return r ? 0 : -1;
+}
+
+int topology_parse_id_list(const char *s, int **out, size_t *out_n) {
+    size_t cap = 16, n = 0;
+    int *ids = malloc(cap * sizeof(int));
+    if (!ids) return -1;
+
+    const char *p = s;
+    while (*p && !isspace((unsigned char)*p)) {
+        char *end = NULL;
+        long lo = strtol(p, &end, 10);
+        if (end == p || lo < 0) { free(ids); return -1; }
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            p++;
+            hi = strtol(p, &end, 10);
+            if (end == p || hi < lo) { free(ids); return -1; }
+            p = end;
+        }
+        for (long v = lo; v <= hi; v++) {
+            if (n >= cap) {
+                cap *= 2;
+                int *tmp = realloc(ids, cap * sizeof(int));
+                if (!tmp) { free(ids); return -1; }
+                ids = tmp;
+            }
+            ids[n++] = (int)v;
+        }
+        if (*p == ',') p++;
+    }
+
+    if (n == 0) { free(ids); ids = NULL; }
+    *out = ids;
+    *out_n = n;
+    return 0;
+}
+
+/* Drop CPUs the process is not allowed to run on. */
+static void filter_allowed_cpus(int *cpus, size_t *n_cpus) {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) return;
+    size_t kept = 0;
+    for (size_t i = 0; i < *n_cpus; i++) {
+        if (cpus[i] < CPU_SETSIZE && CPU_ISSET(cpus[i], &mask)) cpus[kept++] = cpus[i];
+    }
+    *n_cpus = kept;
+#else
+    (void)cpus;
+    (void)n_cpus;
+#endif
+}
+
+/* Single node with every online CPU; used when sysfs has no NUMA information. */
+static int detect_flat(Topology *topo) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+
+    topo->nodes = malloc(sizeof(TopologyNode));
+    int *cpus = malloc((size_t)n * sizeof(int));
+    if (!topo->nodes || !cpus) {
+        free(topo->nodes);
+        free(cpus);
+        topo->nodes = NULL;
+        return -1;
+    }
+    size_t n_cpus = (size_t)n;
+    for (size_t i = 0; i < n_cpus; i++) cpus[i] = (int)i;
+    filter_allowed_cpus(cpus, &n_cpus);
+    if (n_cpus == 0) {
+        /* The mask could not be matched to CPU numbers; fall back to CPU 0. */
+        cpus[0] = 0;
+        n_cpus = 1;
+    }
+
+    topo->nodes[0].id = 0;
+    topo->nodes[0].cpus = cpus;
+    topo->nodes[0].n_cpus = n_cpus;
+    topo->n_nodes = 1;
+    return 0;
+}
+
+/* ---------- Public API ---------- */
+
+int topology_detect(Topology *topo) {
+    if (!topo) return -1;
+    topo->nodes = NULL;
+    topo->n_nodes = 0;
+
+    char buf[4096];
+    int *node_ids = NULL;
+    size_t n_ids = 0;
+    if (read_sysfs_line("/sys/devices/system/node/online", buf, sizeof(buf)) != 0 ||
+        topology_parse_id_list(buf, &node_ids, &n_ids) != 0 || n_ids == 0) {
+        free(node_ids);
+        return detect_flat(topo);
+    }
+
+    topo->nodes = calloc(n_ids, sizeof(TopologyNode));
+    if (!topo->nodes) {
+        free(node_ids);
+        return -1;
+    }
+
+    for (size_t i = 0; i < n_ids; i++) {
+        char path[128];
+        int *cpus = NULL;
+        size_t n_cpus = 0;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node_ids[i]);
+        if (read_sysfs_line(path, buf, sizeof(buf)) != 0) continue;
+        if (topology_parse_id_list(buf, &cpus, &n_cpus) != 0) continue;
+
+        filter_allowed_cpus(cpus, &n_cpus);
+        if (n_cpus == 0) {
+            /* memory-only node, or none of its CPUs are usable */
+            free(cpus);
+            continue;
+        }
+
+        TopologyNode *node = &topo->nodes[topo->n_nodes++];
+        node->id = node_ids[i];
+        node->cpus = cpus;
+        node->n_cpus = n_cpus;
+    }
+    free(node_ids);
+
+    if (topo->n_nodes == 0) {
+        topology_free(topo);
+        return detect_flat(topo);
+    }
+    return 0;
+}
+
+size_t topology_cpu_count(const Topology *topo) {
+    if (!topo) return 0;
+    size_t n = 0;
+    for (size_t i = 0; i < topo->n_nodes; i++) n += topo->nodes[i].n_cpus;
+    return n;
+}
+
+int topology_pin_thread(const int *cpus, size_t n_cpus) {
+#ifdef __linux__
+    if (!cpus || n_cpus == 0) return -1;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t i = 0; i < n_cpus; i++) {
+        if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? 0 : -1;
+#else
+    (void)cpus;
+    (void)n_cpus;
+    return -1;
+#endif
+}
+
+void topology_free(Topology *topo) {
+    if (!topo) return;
+    for (size_t i = 0; i < topo->n_nodes; i++) {
+        free(topo->nodes[i].cpus);
+    }
+    free(topo->nodes);
+    topo->nodes = NULL;
+    topo->n_nodes = 0;
+}
@@ -22,9 +22,32 @@ double utils_mse(const double *predictions, const double *targets, size_t m) {
     return sum / (double)m;
 }
 
+double utils_weighted_mse(const double *predictions, const double *targets,
+                          const double *weights, size_t m) {
+    if (!weights) return utils_mse(predictions, targets, m);
+    if (!predictions || !targets || m == 0) return 0.0;
+    double sum = 0.0;
+    double total = 0.0;
+    for (size_t i = 0; i < m; i++) {
+        double diff = predictions[i] - targets[i];
+        sum += weights[i] * diff * diff;
+        total += weights[i];
+    }
+    return total > 0.0 ? sum / total : 0.0;
+}
+
 void utils_zero_vector(double *v, size_t n) {
     if (!v) return;
     for (size_t i = 0; i < n; i++) {
         v[i] = 0.0;
     }
 }
+
+uint64_t utils_hash_bytes(const void *p, size_t n, uint64_t h) {
+    const unsigned char *bytes = p;
+    for (size_t i = 0; i < n; i++) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
@@ -0,0 +1,173 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "../include/linear_regression.h"
+#include "../include/gradient_descent.h"
+#include "../include/checkpoint.h"
+#include "../include/csv_reader.h"
+
+#define TOLERANCE 1e-12
+
+static char ckpt_path[64];
+
+static void remove_checkpoints(void) {
+    char buf[80];
+    remove(ckpt_path);
+    snprintf(buf, sizeof(buf), "%s.1", ckpt_path);
+    remove(buf);
+    snprintf(buf, sizeof(buf), "%s.tmp", ckpt_path);
+    remove(buf);
+}
+
+/* y = 1 + 2*x0 - x1 on a small grid */
+static CSVData* generate_test_data(void) {
+    const size_t rows = 50, cols = 3;
+    CSVData *data = calloc(1, sizeof(CSVData));
+    if (!data) return NULL;
+    data->rows = rows;
+    data->cols = cols;
+    data->values = malloc(rows * cols * sizeof(double));
+    data->data = malloc(rows * sizeof(double*));
+    if (!data->values || !data->data) {
+        csv_free(data);
+        return NULL;
+    }
+    for (size_t i = 0; i < rows; i++) {
+        double *row = data->values + i * cols;
+        row[0] = (double)(i % 10) / 10.0;
+        row[1] = (double)(i / 10) / 5.0;
+        row[2] = 1.0 + 2.0 * row[0] - row[1];
+        data->data[i] = row;
+    }
+    return data;
+}
+
+/* 30 checkpointed iterations followed by a resumed run of 20 must equal 50
+ * uninterrupted iterations, for full batch (batch_size 0) and mini-batches. */
+static int test_resume_matches_uninterrupted(const CSVData *data, size_t batch_size) {
+    uint64_t fingerprint = csv_fingerprint(data);
+    LinearRegression *straight = lr_create(3);
+    LinearRegression *first = lr_create(3);
+    LinearRegression *resumed = lr_create(3);
+    int failed = !straight || !first || !resumed;
+
+    if (!failed) {
+        GDOptions opts;
+        gd_default_options(&opts);
+        opts.batch_size = batch_size;
+        failed = gradient_descent_ex(straight, data, 0.1, 50, &opts, NULL) != 0;
+    }
+
+    if (!failed) {
+        GDOptions opts;
+        gd_default_options(&opts);
+        opts.batch_size = batch_size;
+        opts.checkpoint = checkpoint_open(ckpt_path, fingerprint, 3);
+        opts.checkpoint_interval = 10;
+        failed = !opts.checkpoint || gradient_descent_ex(first, data, 0.1, 30, &opts, NULL) != 0;
+        failed = checkpoint_close(opts.checkpoint) != 0 || failed;
+    }
+
+    uint64_t iteration = 0, stored_batch = 0;
+    double alpha = 0.0;
+    if (!failed && !checkpoint_load_latest(ckpt_path, fingerprint, 3, resumed->theta,
+                                           &iteration, &alpha, &stored_batch)) {
+        fprintf(stderr, "Test FAILED: no checkpoint to resume from\n");
+        failed = 1;
+    }
+    if (!failed && (iteration != 30 || alpha != 0.1 || stored_batch != batch_size)) {
+        fprintf(stderr, "Test FAILED: checkpoint at iteration %llu, alpha %g, batch %llu\n",
+                (unsigned long long)iteration, alpha, (unsigned long long)stored_batch);
+        failed = 1;
+    }
+
+    if (!failed) {
+        GDOptions opts;
+        gd_default_options(&opts);
+        opts.batch_size = (size_t)stored_batch;
+        opts.start_iteration = (unsigned int)iteration;
+        failed = gradient_descent_ex(resumed, data, alpha, 50 - (unsigned int)iteration,
+                                     &opts, NULL) != 0;
+    }
+
+    for (size_t j = 0; !failed && j < 3; j++) {
+        if (fabs(resumed->theta[j] - straight->theta[j]) > TOLERANCE) {
+            fprintf(stderr, "Test FAILED: resumed theta[%zu] = %.15f, expected %.15f\n",
+                    j, resumed->theta[j], straight->theta[j]);
+            failed = 1;
+        }
+    }
+
+    lr_free(straight);
+    lr_free(first);
+    lr_free(resumed);
+    if (failed) return 1;
+    printf("Test PASSED: resumed training matches uninterrupted training (batch %zu)\n",
+           batch_size);
+    return 0;
+}
+
+/* A damaged newest checkpoint falls back to the previous one; a checkpoint
+ * of other data is rejected. */
+static int test_damaged_and_foreign_checkpoints(const CSVData *data) {
+    uint64_t fingerprint = csv_fingerprint(data);
+    double theta[3] = { 1.0, 2.0, 3.0 };
+    double loaded[3] = { 0.0, 0.0, 0.0 };
+    uint64_t iteration = 0, batch_size = 0;
+    double alpha = 0.0;
+
+    for (uint64_t it = 10; it <= 20; it += 10) {
+        Checkpointer *cp = checkpoint_open(ckpt_path, fingerprint, 3);
+        if (!cp) return 1;
+        theta[0] = (double)it;
+        checkpoint_submit(cp, it, 0.5, 16, theta);
+        if (checkpoint_close(cp) != 0) return 1;
+    }
+
+    FILE *f = fopen(ckpt_path, "r+b");
+    if (!f) return 1;
+    fseek(f, 40, SEEK_SET);
+    fputc(0x5a, f);
+    fclose(f);
+
+    if (!checkpoint_load_latest(ckpt_path, fingerprint, 3, loaded, &iteration, &alpha,
+                                &batch_size) ||
+        iteration != 10 || batch_size != 16 || loaded[0] != 10.0 || loaded[2] != 3.0) {
+        fprintf(stderr, "Test FAILED: did not fall back to the previous checkpoint\n");
+        return 1;
+    }
+
+    if (checkpoint_load_latest(ckpt_path, fingerprint + 1, 3, loaded, &iteration, &alpha,
+                               &batch_size)) {
+        fprintf(stderr, "Test FAILED: checkpoint of other data was accepted\n");
+        return 1;
+    }
+
+    printf("Test PASSED: damaged and foreign checkpoints are skipped\n");
+    return 0;
+}
+
+int main(void) {
+    snprintf(ckpt_path, sizeof(ckpt_path), "/tmp/lr_test_checkpoint_%ld", (long)getpid());
+
+    CSVData *data = generate_test_data();
+    if (!data) {
+        fprintf(stderr, "Failed to generate test data\n");
+        return EXIT_FAILURE;
+    }
+
+    remove_checkpoints();
+    int failed = test_resume_matches_uninterrupted(data, 0) != 0;
+    remove_checkpoints();
+    failed = failed || test_resume_matches_uninterrupted(data, 7) != 0;
+    remove_checkpoints();
+    failed = failed || test_damaged_and_foreign_checkpoints(data) != 0;
+    remove_checkpoints();
+
+    csv_free(data);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,238 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/config.h"
+#include "../include/csv_reader.h"
+
+static char conf_path[64];
+static char profile_path[64];
+
+static int write_file(const char *path, const char *text) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fputs(text, f);
+    return fclose(f);
+}
+
+/* defaults < profile < config file < environment < command line */
+static int test_precedence(void) {
+    write_file(profile_path, "# tuned\nkernel = blocked\nthreads = 3\nblock-size = 64K\n");
+    char conf[256];
+    snprintf(conf, sizeof(conf),
+             "profile = %s\nthreads = 4\nlearning-rate = 0.5  # comment\n"
+             "iterations = 10\nfeatures = a,b\n", profile_path);
+    write_file(conf_path, conf);
+
+    char config_arg[80];
+    snprintf(config_arg, sizeof(config_arg), "--config=%s", conf_path);
+    char *argv[] = { "prog", config_arg, "--iterations=7", "--dedup", "data.csv", "y", NULL };
+
+    setenv("LR_LEARNING_RATE", "0.25", 1);
+    setenv("LR_ITERATIONS", "8", 1);
+    LRConfig cfg;
+    int r = config_load(&cfg, 6, argv);
+    unsetenv("LR_LEARNING_RATE");
+    unsetenv("LR_ITERATIONS");
+
+    int failed = r != 0;
+    failed = failed || cfg.kernel != GD_KERNEL_BLOCKED;          /* profile */
+    failed = failed || cfg.block_bytes != 64 * 1024;             /* profile */
+    failed = failed || cfg.threads != 4;                         /* file over profile */
+    failed = failed || cfg.learning_rate != 0.25;                /* env over file */
+    failed = failed || cfg.iterations != 7;                      /* CLI over env */
+    failed = failed || !cfg.dedup;
+    failed = failed || !cfg.data_path || strcmp(cfg.data_path, "data.csv") != 0;
+    failed = failed || !cfg.target || strcmp(cfg.target, "y") != 0;
+    failed = failed || cfg.n_features != 2 || strcmp(cfg.features[1], "b") != 0;
+    failed = failed || cfg.solver != CONFIG_SOLVER_BATCH;
+    config_free(&cfg);
+
+    /* Autotune ignores the existing profile: it is about to be replaced. */
+    char *tune_argv[] = { "prog", config_arg, "--autotune", "data.csv", NULL };
+    r = config_load(&cfg, 4, tune_argv);
+    failed = failed || r != 0 || !cfg.autotune || cfg.kernel != GD_KERNEL_AUTO;
+    config_free(&cfg);
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: config sources applied out of precedence order\n");
+        return -1;
+    }
+    printf("Test PASSED: config source precedence\n");
+    return 0;
+}
+
+static int test_values(void) {
+    LRConfig cfg;
+    config_init(&cfg);
+    int failed = 0;
+
+    failed = failed || config_set(&cfg, "block-size", "2M", "test") != 0;
+    failed = failed || cfg.block_bytes != 2u << 20;
+    failed = failed || config_set(&cfg, "memory_budget", "1g", "test") != 0;
+    failed = failed || cfg.memory_budget != 1u << 30;
+    failed = failed || config_set(&cfg, "solver", "minibatch", "test") != 0;
+    failed = failed || config_set(&cfg, "batch-size", "32", "test") != 0;
+
+    /* invalid values are rejected and leave the setting untouched */
+    failed = failed || config_set(&cfg, "threads", "-1", "test") == 0;
+    failed = failed || config_set(&cfg, "block-size", "12Q", "test") == 0;
+    failed = failed || config_set(&cfg, "precision", "float", "test") == 0;
+    failed = failed || config_set(&cfg, "learning-rate", "0", "test") == 0;
+    failed = failed || config_set(&cfg, "no-such-key", "1", "test") == 0;
+    failed = failed || cfg.threads != 1 || cfg.block_bytes != 2u << 20;
+
+    char *argv[] = { "prog", "--threads", "data.csv", NULL };
+    LRConfig loaded;
+    failed = config_load(&loaded, 3, argv) != -1 || failed;
+    config_free(&loaded);
+
+    GDOptions opts;
+    config_gd_options(&cfg, &opts);
+    failed = failed || opts.batch_size != 32 || opts.block_bytes != 2u << 20;
+
+    /* first-touch falls back to shared when only its copy exceeds the budget;
+       the worker buffers count towards it */
+    double values[8] = { 0 };
+    double *rows[4] = { values, values + 2, values + 4, values + 6 };
+    CSVData data = { .data = rows, .values = values, .rows = 4, .cols = 2 };
+    size_t data_bytes = sizeof(values) + sizeof(rows);
+    opts.placement = GD_PLACE_SHARED;
+    size_t shared = gd_working_set(&data, &opts);
+    opts.placement = GD_PLACE_FIRST_TOUCH;
+    failed = failed || gd_working_set(&data, &opts) < shared + sizeof(values);
+    cfg.memory_budget = data_bytes + shared;
+    failed = failed || config_check_memory(&cfg, &data, &opts) != 0;
+    failed = failed || opts.placement != GD_PLACE_SHARED;
+    cfg.memory_budget = data_bytes + shared - 1;
+    failed = failed || config_check_memory(&cfg, &data, &opts) == 0;
+    config_free(&cfg);
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: config values parsed or validated incorrectly\n");
+        return -1;
+    }
+    printf("Test PASSED: config value parsing and memory budget\n");
+    return 0;
+}
+
+static int test_profile_round_trip(void) {
+    LRConfig cfg;
+    config_init(&cfg);
+    cfg.kernel = GD_KERNEL_ROWS;
+    cfg.threads = 6;
+    cfg.block_bytes = 128 * 1024;
+    cfg.tuned_inputs = 5;
+    int failed = config_save_profile(&cfg, profile_path) != 0;
+    config_free(&cfg);
+
+    LRConfig loaded;
+    config_init(&loaded);
+    failed = failed || config_load_file(&loaded, profile_path) != 0;
+    failed = failed || loaded.kernel != GD_KERNEL_ROWS || loaded.threads != 6 ||
+             loaded.block_bytes != 128 * 1024 || loaded.tuned_inputs != 5;
+    config_free(&loaded);
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: saved profile does not load back\n");
+        return -1;
+    }
+    printf("Test PASSED: profile round trip\n");
+    return 0;
+}
+
+/* An autotune run without --profile saves the default profile, and a plain
+ * later run in the same directory picks it up. */
+static int test_autotune_reused(void) {
+    char dir[] = "/tmp/lr_test_autotune_XXXXXX";
+    char cwd[4096];
+    if (!getcwd(cwd, sizeof(cwd)) || !mkdtemp(dir) || chdir(dir) != 0) return -1;
+
+    enum { ROWS = 64, COLS = 3 };
+    double values[ROWS * COLS];
+    double *rows[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        double *row = values + i * COLS;
+        row[0] = (double)(i % 8);
+        row[1] = (double)(i / 8);
+        row[2] = 1.0 + 2.0 * row[0] - row[1];
+        rows[i] = row;
+    }
+    CSVData data = { .data = rows, .values = values, .rows = ROWS, .cols = COLS };
+
+    char *tune_argv[] = { "prog", "--autotune", "data.csv", NULL };
+    char *plain_argv[] = { "prog", "data.csv", NULL };
+    LRConfig tuned, later;
+    int failed = config_load(&tuned, 3, tune_argv) != 0;
+    failed = failed || config_autotune(&tuned, &data) != 0;
+    failed = config_load(&later, 2, plain_argv) != 0 || failed;
+
+    /* autotune always settles on a concrete kernel, never "auto" */
+    failed = failed || later.kernel == GD_KERNEL_AUTO || later.kernel != tuned.kernel ||
+             later.threads != tuned.threads || later.block_bytes != tuned.block_bytes;
+    failed = failed || later.tuned_inputs != COLS - 1 || config_match_profile(&later, &data) != 0;
+    config_free(&tuned);
+    config_free(&later);
+
+    remove(CONFIG_DEFAULT_PROFILE);
+    if (chdir(cwd) != 0 || rmdir(dir) != 0) failed = 1;
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: later run did not load the autotuned profile\n");
+        return -1;
+    }
+    printf("Test PASSED: autotuned profile is reused by default\n");
+    return 0;
+}
+
+/* A profile's kernel and block size apply only to data of the tuned width;
+ * its thread count and explicit settings apply to any data. */
+static int test_profile_width(void) {
+    write_file(profile_path, "kernel = blocked\nthreads = 3\nblock-size = 64K\ntuned-inputs = 2\n");
+    char profile_arg[80];
+    snprintf(profile_arg, sizeof(profile_arg), "--profile=%s", profile_path);
+
+    double values[2 * 5] = { 0 };
+    double *rows[2] = { values, values + 5 };
+    CSVData narrow = { .data = rows, .values = values, .rows = 2, .cols = 3 };
+    CSVData wide = { .data = rows, .values = values, .rows = 2, .cols = 5 };
+
+    char *argv[] = { "prog", profile_arg, "data.csv", NULL };
+    LRConfig cfg;
+    int failed = config_load(&cfg, 3, argv) != 0;
+    failed = failed || config_match_profile(&cfg, &narrow) != 0;
+    failed = failed || cfg.kernel != GD_KERNEL_BLOCKED || cfg.block_bytes != 64 * 1024;
+    failed = failed || config_match_profile(&cfg, &wide) != 1;
+    failed = failed || cfg.kernel != GD_KERNEL_AUTO || cfg.block_bytes != GD_DEFAULT_BLOCK_BYTES;
+    failed = failed || cfg.threads != 3;
+    config_free(&cfg);
+
+    char *forced_argv[] = { "prog", profile_arg, "--kernel=blocked", "data.csv", NULL };
+    failed = config_load(&cfg, 4, forced_argv) != 0 || failed;
+    failed = failed || config_match_profile(&cfg, &wide) != 0 || cfg.kernel != GD_KERNEL_BLOCKED;
+    config_free(&cfg);
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: profile tuned for another width was applied\n");
+        return -1;
+    }
+    printf("Test PASSED: profile applies only to data of its width\n");
+    return 0;
+}
+
+int main(void) {
+    snprintf(conf_path, sizeof(conf_path), "/tmp/lr_test_config_%ld.conf", (long)getpid());
+    snprintf(profile_path, sizeof(profile_path), "/tmp/lr_test_profile_%ld.conf", (long)getpid());
+
+    int failed = test_precedence() != 0;
+    failed = test_values() != 0 || failed;
+    failed = test_profile_round_trip() != 0 || failed;
+    failed = test_autotune_reused() != 0 || failed;
+    failed = test_profile_width() != 0 || failed;
+
+    remove(conf_path);
+    remove(profile_path);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
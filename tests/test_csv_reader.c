@@ -1,9 +1,23 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
 #include "../include/csv_reader.h"
 
+#define TOLERANCE 1e-9
+
 static void print_csv_data(const CSVData *csv) {
     printf("Rows: %zu, Cols: %zu\n", csv->rows, csv->cols);
+    if (csv->col_names) {
+        printf("Columns:");
+        for (size_t j = 0; j < csv->cols; j++) {
+            printf(" %s", csv->col_names[j]);
+        }
+        printf("\n");
+    }
     for (size_t i = 0; i < csv->rows; i++) {
         printf("Row %zu:", i);
         for (size_t j = 0; j < csv->cols; j++) {
@@ -13,6 +27,121 @@ static void print_csv_data(const CSVData *csv) {
     }
 }
 
+/* Select two features by name and index and a target by name; the text
+ * columns in between must be skipped without being parsed. */
+static int test_schema_projection(void) {
+    const char *test_file = "data/sample_wide.csv";
+    const char *features[] = { "rooms", "2" };
+    CSVSchema schema = { .features = features, .n_features = 2, .target = "profit" };
+
+    CSVData *csv = csv_read_schema(test_file, &schema);
+    if (!csv) {
+        fprintf(stderr, "Failed to read %s with schema\n", test_file);
+        return 1;
+    }
+
+    print_csv_data(csv);
+
+    static const double expected[4][3] = {
+        { 3, 6.1101, 17.592 },
+        { 2, 5.5277, 9.1302 },
+        { 4, 8.5186, 13.662 },
+        { 3, 7.0032, 11.854 },
+    };
+    static const char *expected_names[3] = { "rooms", "population", "profit" };
+
+    int failed = csv->rows != 4 || csv->cols != 3 || !csv->col_names;
+    for (size_t j = 0; !failed && j < csv->cols; j++) {
+        if (strcmp(csv->col_names[j], expected_names[j]) != 0) failed = 1;
+    }
+    for (size_t i = 0; !failed && i < csv->rows; i++) {
+        for (size_t j = 0; j < csv->cols; j++) {
+            if (fabs(csv->data[i][j] - expected[i][j]) > TOLERANCE) failed = 1;
+        }
+    }
+    csv_free(csv);
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: projected data does not match the schema\n");
+        return 1;
+    }
+
+    /* Selecting a text column must still be rejected. */
+    const char *bad_features[] = { "city" };
+    CSVSchema bad = { .features = bad_features, .n_features = 1, .target = "profit" };
+    csv = csv_read_schema(test_file, &bad);
+    if (csv) {
+        fprintf(stderr, "Test FAILED: non-numeric selected column was accepted\n");
+        csv_free(csv);
+        return 1;
+    }
+
+    printf("Test PASSED: schema projection\n");
+    return 0;
+}
+
+/* 4 rows of 3 selected columns take 4 * (3 doubles + 1 row pointer) = 128
+ * bytes: that fits a limit of 128 but not one of 127. */
+static int test_byte_limit(void) {
+    const char *test_file = "data/sample_wide.csv";
+    const char *features[] = { "rooms", "population" };
+    CSVSchema schema = { .features = features, .n_features = 2, .target = "profit",
+                         .max_bytes = 128 };
+
+    CSVData *csv = csv_read_schema(test_file, &schema);
+    int failed = !csv || csv->rows != 4;
+    csv_free(csv);
+
+    schema.max_bytes = 127;
+    csv = csv_read_schema(test_file, &schema);
+    if (csv) {
+        failed = 1;
+        csv_free(csv);
+    }
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: byte limit not applied while loading\n");
+        return 1;
+    }
+    printf("Test PASSED: byte limit\n");
+    return 0;
+}
+
+/* A headerless file whose unselected first column holds text: the first row
+ * is data when the selected columns are numeric, and selecting the text
+ * column fails instead of taking the first row for a header. */
+static int test_headerless_mixed(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/lr_test_headerless_%ld.csv", (long)getpid());
+    FILE *f = fopen(path, "w");
+    if (!f) return 1;
+    fputs("NY,1,2,3\nLA,2,3,5\nSF,3,5,8\n", f);
+    fclose(f);
+
+    const char *features[] = { "1", "2" };
+    CSVSchema schema = { .features = features, .n_features = 2, .target = "3" };
+    CSVData *csv = csv_read_schema(path, &schema);
+    int failed = !csv || csv->rows != 3 || csv->cols != 3 || csv->col_names != NULL;
+    if (!failed) {
+        failed = csv->data[0][0] != 1.0 || csv->data[0][2] != 3.0 || csv->data[2][1] != 5.0;
+    }
+    csv_free(csv);
+
+    csv = csv_read(path);
+    if (csv) {
+        failed = 1;
+        csv_free(csv);
+    }
+    remove(path);
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: headerless mixed-type file misread\n");
+        return 1;
+    }
+    printf("Test PASSED: headerless file with text columns\n");
+    return 0;
+}
+
 int main(void) {
     const char *test_file = "data/sample.csv";
 
@@ -25,5 +154,10 @@ int main(void) {
     print_csv_data(csv);
 
     csv_free(csv);
+
+    if (test_schema_projection() != 0) return EXIT_FAILURE;
+    if (test_byte_limit() != 0) return EXIT_FAILURE;
+    if (test_headerless_mixed() != 0) return EXIT_FAILURE;
+
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -1,9 +1,11 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../include/linear_regression.h"
 #include "../include/gradient_descent.h"
 #include "../include/csv_reader.h"
+#include "../include/kernels.h"
 
 #define TOLERANCE 1e-3
 
@@ -13,6 +15,9 @@ static CSVData* generate_test_data(size_t m) {
 
     data->rows = m;
     data->cols = 2; 
+    data->col_names = NULL;
+    data->values = NULL;
+    data->weights = NULL;
     data->data = malloc(m * sizeof(double*));
     if (!data->data) {
         free(data);
@@ -35,6 +40,396 @@ static CSVData* generate_test_data(size_t m) {
     return data;
 }
 
+/* Every unrolled kernel must reproduce the generic kernel exactly. */
+static int test_kernels_match_generic(void) {
+    enum { ROWS = 37, MAX_COLS = KERNELS_MAX_UNROLLED + 2 };
+    double storage[ROWS][MAX_COLS];
+    double *rows[ROWS];
+    double theta[MAX_COLS];
+    double weights[ROWS];
+
+    srand(7);
+    for (size_t i = 0; i < ROWS; i++) {
+        for (size_t j = 0; j < MAX_COLS; j++) {
+            storage[i][j] = (double)rand() / RAND_MAX - 0.5;
+        }
+        rows[i] = storage[i];
+    }
+    for (size_t j = 0; j < MAX_COLS; j++) theta[j] = 0.25 * (double)j - 1.0;
+    for (size_t i = 0; i < ROWS; i++) weights[i] = (double)(i % 4);
+
+    for (size_t n = 0; n <= KERNELS_MAX_UNROLLED + 1; n++) {
+        const LRKernels *k = kernels_select(n);
+        const LRKernels *g = kernels_generic();
+        for (int weighted = 0; weighted <= 1; weighted++) {
+            const double *w = weighted ? weights : NULL;
+            double grad_k[MAX_COLS];
+            double grad_g[MAX_COLS];
+            for (size_t j = 0; j < MAX_COLS; j++) grad_k[j] = grad_g[j] = 0.5 * (double)j - 1.3;
+
+            /* kernels add to a non-zero grad, e.g. a range split in two calls */
+            k->gradient(theta, rows, w, 11, n, grad_k);
+            k->gradient(theta, rows + 11, w ? w + 11 : NULL, ROWS - 11, n, grad_k);
+            g->gradient(theta, rows, w, ROWS, n, grad_g);
+
+            for (size_t j = 0; j <= n; j++) {
+                if (grad_k[j] != grad_g[j]) {
+                    fprintf(stderr, "Test FAILED: gradient kernel for %zu inputs differs at %zu%s\n",
+                            n, j, weighted ? " (weighted)" : "");
+                    return 1;
+                }
+            }
+        }
+        if (k->predict(theta, rows[3], n) != g->predict(theta, rows[3], n)) {
+            fprintf(stderr, "Test FAILED: predict kernel for %zu inputs differs\n", n);
+            return 1;
+        }
+    }
+
+    printf("Test PASSED: unrolled kernels match the generic kernel\n");
+    return 0;
+}
+
+/* Row-by-row batch gradient descent as originally written; reference for
+ * the blocked GEMV path. */
+static void reference_descent(double *theta, const CSVData *data, double alpha,
+                              unsigned int iterations) {
+    size_t m = data->rows;
+    size_t n = data->cols - 1;
+    double *grad = calloc(n + 1, sizeof(double));
+    if (!grad) return;
+
+    for (unsigned int iter = 0; iter < iterations; ++iter) {
+        for (size_t j = 0; j <= n; ++j) grad[j] = 0.0;
+        for (size_t i = 0; i < m; ++i) {
+            double prediction = theta[0];
+            for (size_t j = 0; j < n; ++j) prediction += theta[j + 1] * data->data[i][j];
+            double error = prediction - data->data[i][n];
+            grad[0] += error;
+            for (size_t j = 0; j < n; ++j) grad[j + 1] += error * data->data[i][j];
+        }
+        for (size_t j = 0; j <= n; ++j) theta[j] -= (alpha / (double)m) * grad[j];
+    }
+    free(grad);
+}
+
+/* Feature counts above the unrolled range train through the blocked GEMV
+ * path; it must agree with the row-by-row reference. Enough rows are used to
+ * span several row blocks. */
+static int test_blocked_matches_reference(void) {
+    enum { ROWS = 3000, INPUTS = 24, COLS = INPUTS + 1 };
+    const double alpha = 0.05;
+    const unsigned int iterations = 50;
+
+    CSVData data = { .rows = ROWS, .cols = COLS };
+    data.values = malloc((size_t)ROWS * COLS * sizeof(double));
+    data.data = malloc(ROWS * sizeof(double*));
+    LinearRegression *lr = lr_create(COLS);
+    double *reference = calloc(COLS, sizeof(double));
+    if (!data.values || !data.data || !lr || !reference) {
+        free(data.values);
+        free(data.data);
+        lr_free(lr);
+        free(reference);
+        return 1;
+    }
+
+    srand(11);
+    for (size_t i = 0; i < ROWS; i++) {
+        double *row = data.values + i * COLS;
+        double y = 0.5;
+        for (size_t j = 0; j < INPUTS; j++) {
+            row[j] = (double)rand() / RAND_MAX;
+            y += 0.1 * (double)j * row[j];
+        }
+        row[INPUTS] = y;
+        data.data[i] = row;
+    }
+
+    int r = gradient_descent(lr, &data, alpha, iterations);
+    reference_descent(reference, &data, alpha, iterations);
+
+    int failed = r != 0;
+    for (size_t j = 0; !failed && j < COLS; j++) {
+        if (fabs(lr->theta[j] - reference[j]) > 1e-9 * (1.0 + fabs(reference[j]))) {
+            fprintf(stderr, "Test FAILED: blocked theta[%zu] = %.12f, reference %.12f\n",
+                    j, lr->theta[j], reference[j]);
+            failed = 1;
+        }
+    }
+
+    free(data.values);
+    free(data.data);
+    lr_free(lr);
+    free(reference);
+
+    if (failed) return 1;
+    printf("Test PASSED: blocked GEMV path matches reference\n");
+    return 0;
+}
+
+/* Contiguous CSVData (as csv_read() builds it) with y = 0.5 + sum 0.1*j*x_j. */
+static CSVData* generate_dense_data(size_t rows, size_t inputs, unsigned int seed) {
+    size_t cols = inputs + 1;
+    CSVData *data = calloc(1, sizeof(CSVData));
+    if (!data) return NULL;
+    data->rows = rows;
+    data->cols = cols;
+    data->values = malloc(rows * cols * sizeof(double));
+    data->data = malloc(rows * sizeof(double*));
+    if (!data->values || !data->data) {
+        csv_free(data);
+        return NULL;
+    }
+
+    srand(seed);
+    for (size_t i = 0; i < rows; i++) {
+        double *row = data->values + i * cols;
+        double y = 0.5;
+        for (size_t j = 0; j < inputs; j++) {
+            row[j] = (double)rand() / RAND_MAX;
+            y += 0.1 * (double)j * row[j];
+        }
+        row[inputs] = y;
+        data->data[i] = row;
+    }
+    return data;
+}
+
+static int thetas_close(const char *what, const double *got, const double *want, size_t n) {
+    for (size_t j = 0; j < n; j++) {
+        if (fabs(got[j] - want[j]) > 1e-9 * (1.0 + fabs(want[j]))) {
+            fprintf(stderr, "Test FAILED: %s theta[%zu] = %.12f, expected %.12f\n",
+                    what, j, got[j], want[j]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Several pinned workers with first-touch placement must reach the same
+ * parameters as one worker, for both the unrolled and the blocked path. */
+static int test_threaded_matches_single(void) {
+    static const size_t inputs[] = { 3, 24 };
+    GDOptions opts;
+    gd_default_options(&opts);
+    opts.threads = 4;
+    opts.pin = GD_PIN_CORE;
+    opts.placement = GD_PLACE_FIRST_TOUCH;
+
+    for (size_t k = 0; k < sizeof(inputs) / sizeof(inputs[0]); k++) {
+        size_t n = inputs[k] + 1;
+        CSVData *data = generate_dense_data(1001, inputs[k], 5);
+        LinearRegression *single = lr_create(n);
+        LinearRegression *multi = lr_create(n);
+        GDStats stats;
+        int failed = !data || !single || !multi;
+
+        if (!failed) {
+            failed = gradient_descent(single, data, 0.05, 40) != 0 ||
+                     gradient_descent_ex(multi, data, 0.05, 40, &opts, &stats) != 0;
+        }
+        if (!failed && stats.threads != 4) {
+            fprintf(stderr, "Test FAILED: expected 4 workers, got %u\n", stats.threads);
+            failed = 1;
+        }
+        if (!failed && stats.backend_threads != 1) {
+            fprintf(stderr, "Test FAILED: BLAS kept %d threads under 4 workers\n",
+                    stats.backend_threads);
+            failed = 1;
+        }
+        failed = failed || !thetas_close("threaded", multi->theta, single->theta, n);
+
+        csv_free(data);
+        lr_free(single);
+        lr_free(multi);
+        if (failed) return 1;
+    }
+
+    printf("Test PASSED: threaded training matches single worker\n");
+    return 0;
+}
+
+/* Training on duplicate rows compacted into weighted samples must match
+ * training on the expanded rows, for both training paths. */
+static int test_compaction_matches_expanded(void) {
+    static const size_t inputs[] = { 2, 24 };
+    const size_t rows = 600, distinct = 37;
+    GDOptions opts;
+    gd_default_options(&opts);
+    opts.threads = 3;
+    opts.placement = GD_PLACE_FIRST_TOUCH;
+
+    for (size_t k = 0; k < sizeof(inputs) / sizeof(inputs[0]); k++) {
+        size_t n = inputs[k] + 1;
+        CSVData *expanded = generate_dense_data(rows, inputs[k], 9);
+        CSVData *compacted = generate_dense_data(rows, inputs[k], 9);
+        LinearRegression *lr_expanded = lr_create(n);
+        LinearRegression *lr_compacted = lr_create(n);
+        int failed = !expanded || !compacted || !lr_expanded || !lr_compacted;
+
+        for (size_t i = distinct; !failed && i < rows; i++) {
+            for (size_t j = 0; j < n; j++) {
+                expanded->data[i][j] = expanded->data[i % distinct][j];
+                compacted->data[i][j] = compacted->data[i % distinct][j];
+            }
+        }
+
+        if (!failed && csv_compact_duplicates(compacted) != (long)(rows - distinct)) {
+            fprintf(stderr, "Test FAILED: expected %zu rows after compaction, got %zu\n",
+                    distinct, compacted->rows);
+            failed = 1;
+        }
+        if (!failed) {
+            double total = 0.0;
+            for (size_t i = 0; i < compacted->rows; i++) total += compacted->weights[i];
+            if (total != (double)rows) {
+                fprintf(stderr, "Test FAILED: compacted weights sum to %g\n", total);
+                failed = 1;
+            }
+        }
+        if (!failed) {
+            failed = gradient_descent(lr_expanded, expanded, 0.05, 60) != 0 ||
+                     gradient_descent_ex(lr_compacted, compacted, 0.05, 60, &opts, NULL) != 0;
+        }
+        failed = failed || !thetas_close("compacted", lr_compacted->theta, lr_expanded->theta, n);
+
+        csv_free(expanded);
+        csv_free(compacted);
+        lr_free(lr_expanded);
+        lr_free(lr_compacted);
+        if (failed) return 1;
+    }
+
+    printf("Test PASSED: weighted compacted rows match expanded rows\n");
+    return 0;
+}
+
+/* Mini-batch descent written out directly: iteration t steps over the
+ * window of `batch` rows starting at row t*batch mod rows, wrapping around.
+ * A row of integer weight k is added k times, as if the rows were expanded. */
+static void minibatch_reference(double *theta, const CSVData *data, double alpha,
+                                unsigned int iterations, size_t batch) {
+    size_t m = data->rows;
+    size_t n = data->cols - 1;
+    double *grad = calloc(n + 1, sizeof(double));
+    if (!grad) return;
+
+    for (unsigned int iter = 0; iter < iterations; ++iter) {
+        size_t count = 0;
+        for (size_t j = 0; j <= n; ++j) grad[j] = 0.0;
+        for (size_t k = 0; k < batch; ++k) {
+            size_t i = ((size_t)iter * batch + k) % m;
+            size_t copies = data->weights ? (size_t)data->weights[i] : 1;
+            double prediction = theta[0];
+            for (size_t j = 0; j < n; ++j) prediction += theta[j + 1] * data->data[i][j];
+            double error = prediction - data->data[i][n];
+            for (size_t c = 0; c < copies; ++c) {
+                grad[0] += error;
+                for (size_t j = 0; j < n; ++j) grad[j + 1] += error * data->data[i][j];
+            }
+            count += copies;
+        }
+        if (count == 0) continue;
+        for (size_t j = 0; j <= n; ++j) theta[j] -= (alpha / (double)count) * grad[j];
+    }
+    free(grad);
+}
+
+/* Mini-batches with several workers: 64 does not divide 1001 rows, so windows
+ * wrap past the last row and straddle worker blocks. Covers the unrolled and
+ * the blocked path, unweighted and with integer weights (some zero). */
+static int test_minibatch_matches_reference(void) {
+    static const size_t inputs[] = { 3, 24 };
+    const size_t rows = 1001, batch = 64;
+    const unsigned int iterations = 40;
+    GDOptions opts;
+    gd_default_options(&opts);
+    opts.threads = 4;
+    opts.batch_size = batch;
+
+    for (size_t k = 0; k < sizeof(inputs) / sizeof(inputs[0]); k++) {
+        for (int weighted = 0; weighted <= 1; weighted++) {
+            size_t n = inputs[k] + 1;
+            CSVData *data = generate_dense_data(rows, inputs[k], 13);
+            LinearRegression *lr = lr_create(n);
+            double *reference = calloc(n, sizeof(double));
+            GDStats stats;
+            int failed = !data || !lr || !reference;
+
+            if (!failed && weighted) {
+                data->weights = malloc(rows * sizeof(double));
+                failed = !data->weights;
+                for (size_t i = 0; !failed && i < rows; i++) data->weights[i] = (double)(i % 4);
+            }
+            if (!failed) {
+                failed = gradient_descent_ex(lr, data, 0.05, iterations, &opts, &stats) != 0;
+                minibatch_reference(reference, data, 0.05, iterations, batch);
+            }
+            if (!failed && (stats.threads != 4 || stats.batch_size != batch)) {
+                fprintf(stderr, "Test FAILED: mini-batch ran %u workers, %zu rows/step\n",
+                        stats.threads, stats.batch_size);
+                failed = 1;
+            }
+            failed = failed || !thetas_close(weighted ? "weighted mini-batch" : "mini-batch",
+                                             lr->theta, reference, n);
+
+            csv_free(data);
+            lr_free(lr);
+            free(reference);
+            if (failed) return 1;
+        }
+    }
+
+    printf("Test PASSED: mini-batches match reference\n");
+    return 0;
+}
+
+/* Forcing the blocked kernel below the unrolled range, or the row kernels
+ * above it, must still agree with the row-by-row reference. */
+static int test_forced_kernels_match_reference(void) {
+    static const struct {
+        size_t inputs;
+        GDKernel kernel;
+        const char *name;
+    } cases[] = {
+        { 5,  GD_KERNEL_BLOCKED, "blocked-gemv" },
+        { 20, GD_KERNEL_ROWS,    "generic" },
+    };
+
+    for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        size_t n = cases[k].inputs + 1;
+        CSVData *data = generate_dense_data(700, cases[k].inputs, 17);
+        LinearRegression *lr = lr_create(n);
+        double *reference = calloc(n, sizeof(double));
+        GDOptions opts;
+        GDStats stats;
+        int failed = !data || !lr || !reference;
+
+        gd_default_options(&opts);
+        opts.kernel = cases[k].kernel;
+        opts.block_bytes = 4096;    /* several blocks over 700 rows */
+        if (!failed) {
+            failed = gradient_descent_ex(lr, data, 0.05, 50, &opts, &stats) != 0;
+            reference_descent(reference, data, 0.05, 50);
+        }
+        if (!failed && strcmp(stats.kernel, cases[k].name) != 0) {
+            fprintf(stderr, "Test FAILED: forced kernel ran as %s, expected %s\n",
+                    stats.kernel, cases[k].name);
+            failed = 1;
+        }
+        failed = failed || !thetas_close(cases[k].name, lr->theta, reference, n);
+
+        csv_free(data);
+        lr_free(lr);
+        free(reference);
+        if (failed) return 1;
+    }
+
+    printf("Test PASSED: forced kernels match reference\n");
+    return 0;
+}
+
 int main(void) {
     size_t m = 20;
     CSVData *data = generate_test_data(m);
@@ -73,5 +468,13 @@ int main(void) {
 
     lr_free(lr);
     csv_free(data);
+
+    if (test_kernels_match_generic() != 0) return 1;
+    if (test_blocked_matches_reference() != 0) return 1;
+    if (test_threaded_matches_single() != 0) return 1;
+    if (test_compaction_matches_expanded() != 0) return 1;
+    if (test_minibatch_matches_reference() != 0) return 1;
+    if (test_forced_kernels_match_reference() != 0) return 1;
+
     return 0;
 }
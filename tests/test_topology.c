@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/topology.h"
+
+/* sysfs cpulist syntax; multi-node machines are not available to test on,
+ * so the parser that reads their layout is checked directly. */
+static int test_parse_id_list(void) {
+    const int expected[] = { 0, 1, 2, 3, 8, 10, 11 };
+    const size_t n_expected = sizeof(expected) / sizeof(expected[0]);
+    int *ids = NULL;
+    size_t n = 0;
+
+    int failed = topology_parse_id_list("0-3,8,10-11\n", &ids, &n) != 0 || n != n_expected;
+    for (size_t i = 0; !failed && i < n; i++) {
+        failed = ids[i] != expected[i];
+    }
+    free(ids);
+
+    failed = failed || topology_parse_id_list("\n", &ids, &n) != 0 || ids != NULL || n != 0;
+
+    /* malformed lists are rejected */
+    failed = failed || topology_parse_id_list("3-1", &ids, &n) == 0;
+    failed = failed || topology_parse_id_list("0,x", &ids, &n) == 0;
+    failed = failed || topology_parse_id_list("-2", &ids, &n) == 0;
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: CPU list parsed incorrectly\n");
+        return -1;
+    }
+    printf("Test PASSED: CPU list parsing\n");
+    return 0;
+}
+
+static int test_detect(void) {
+    Topology topo;
+    if (topology_detect(&topo) != 0) {
+        fprintf(stderr, "Test FAILED: topology detection failed\n");
+        return -1;
+    }
+    int failed = topo.n_nodes == 0 || topology_cpu_count(&topo) == 0;
+    for (size_t i = 0; !failed && i < topo.n_nodes; i++) {
+        failed = topo.nodes[i].n_cpus == 0 || (i > 0 && topo.nodes[i].id <= topo.nodes[i - 1].id);
+    }
+    topology_free(&topo);
+
+    if (failed) {
+        fprintf(stderr, "Test FAILED: detected topology is inconsistent\n");
+        return -1;
+    }
+    printf("Test PASSED: topology detection\n");
+    return 0;
+}
+
+int main(void) {
+    int failed = test_parse_id_list() != 0;
+    failed = test_detect() != 0 || failed;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}